@@ -0,0 +1,51 @@
+#!/usr/bin/env bash
+# Compara políticas sobre a mesma carga: executa o arquivo em tempo virtual trocando
+# apenas o código da política (o valor após os N processos, antes das diretivas)
+# e resume resposta e turnaround.
+#
+# Uso: bench/compare_policies.sh [CARGA] [CPUS]
+#   Sem CARGA, gera uma carga mista (muitos processos curtos e alguns longos).
+#
+# Variáveis de ambiente:
+#   COMPARE_POLICIES  códigos das políticas (padrão: "2 3 6" = RR, PRIORITY, MLFQ)
+set -euo pipefail
+
+cd "$(dirname "$0")/.."
+
+KERNEL=./trabSO
+GENERATOR=./tools/workload_generator
+WORKDIR=bench/cargas
+POLICIES=${COMPARE_POLICIES:-"2 3 6"}
+
+TRACE=${1:-}
+CPUS=${2:-1}
+
+mkdir -p "$WORKDIR"
+
+if [ -z "$TRACE" ]; then
+    TRACE="$WORKDIR/mista.txt"
+    "$GENERATOR" -n 2000 -a poisson -r 250 -l exp:150 -P uniform:1:5 -t fixed:1 -s 7 > "$TRACE"
+fi
+
+printf "%-9s %10s %10s %10s %10s %12s %12s %12s %12s\n" policy resp_mean resp_p50 resp_p90 resp_p99 \
+    turn_mean turn_p99 preemptions deadline_miss
+
+for policy in $POLICIES; do
+    input="$WORKDIR/compare_${policy}.txt"
+    metrics="$WORKDIR/compare_${policy}.csv"
+    awk -v p="$policy" '
+        NR == 1 { n = $1 }
+        { for (i = 1; i <= NF; i++) if (++token == 4 * n + 2) $i = p; print }
+    ' "$TRACE" > "$input"
+    "$KERNEL" --virtual --binary-log --cpus "$CPUS" --metrics "$metrics" "$input" > /dev/null
+
+    awk -F, '
+        $1 == "policy"        { name = $2 }
+        $1 == "response_ms"   { rm = $2; r50 = $3; r90 = $4; r99 = $5 }
+        $1 == "turnaround_ms" { tm = $2; t99 = $5 }
+        $1 == "preemptions"   { pre = $2 }
+        $1 == "deadline_misses" { miss = $2 }
+        END { printf "%-9s %10s %10s %10s %10s %12s %12s %12s %12s\n", name, rm, r50, r90, r99, tm, t99, pre, (miss == "" ? "-" : miss) }
+    ' "$metrics"
+    rm -f "$input" "$metrics"
+done
@@ -0,0 +1,50 @@
+#!/usr/bin/env bash
+# Vazão de processos largos (várias threads) com gang scheduling (--gang) contra a
+# expansão atual (uma CPU extra por despacho e CPUs livres depois), os dois com as
+# threads presas às CPUs do processo (--bind-threads), em tempo virtual.
+#
+# Uso: bench/gang_throughput.sh [CPUS]
+#
+# Variáveis de ambiente:
+#   GANG_POLICIES   códigos das políticas (padrão: "1 2 3 5 6 7")
+#   GANG_SIZE       processos da carga (padrão: 200)
+#   GANG_THREADS    distribuição das threads (padrão: uniform:1:8)
+set -euo pipefail
+
+cd "$(dirname "$0")/.."
+
+KERNEL=./trabSO
+GENERATOR=./tools/workload_generator
+WORKDIR=bench/cargas
+POLICIES=${GANG_POLICIES:-"1 2 3 5 6 7"}
+SIZE=${GANG_SIZE:-200}
+THREADS=${GANG_THREADS:-uniform:1:8}
+CPUS=${1:-8}
+
+mkdir -p "$WORKDIR"
+
+printf "%-9s %-10s %12s %14s %12s %12s %10s\n" policy mode duration_ms throughput_s turn_mean turn_p99 backfills
+
+for policy in $POLICIES; do
+    input="$WORKDIR/gang_${policy}.txt"
+    metrics="$WORKDIR/gang_${policy}.csv"
+    "$GENERATOR" -n "$SIZE" -p "$policy" -a poisson -r 60 -t "$THREADS" -s 7 > "$input"
+
+    for mode in expansao gang; do
+        flag=--bind-threads
+        if [ "$mode" = gang ]; then
+            flag=--gang
+        fi
+        "$KERNEL" --virtual --binary-log --cpus "$CPUS" "$flag" --metrics "$metrics" "$input" > /dev/null
+
+        awk -F, -v mode="$mode" '
+            $1 == "policy"           { name = $2 }
+            $1 == "duration_ms"      { dur = $2 }
+            $1 == "throughput_per_s" { thr = $2 }
+            $1 == "turnaround_ms"    { tm = $2; t99 = $5 }
+            $1 == "gang_backfills"   { bf = $2 }
+            END { printf "%-9s %-10s %12s %14s %12s %12s %10s\n", name, mode, dur, thr, tm, t99, (bf == "" ? "-" : bf) }
+        ' "$metrics"
+    done
+    rm -f "$input" "$metrics"
+done
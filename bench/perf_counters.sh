@@ -0,0 +1,42 @@
+#!/usr/bin/env bash
+# Contadores de cache (perf stat) do kernel em multiprocessador com muitos processos:
+# uma carga em tempo real, em que workers e escalonador disputam os PCBs, e uma
+# grande em tempo virtual, limitada pela passagem do escalonador pelos PCBs.
+# Compare duas revisões rodando o script em cada uma.
+#
+# Uso: bench/perf_counters.sh [CPUS]
+#
+# Variáveis de ambiente:
+#   PERF_EVENTS         eventos do perf (padrão: ciclos, instruções, referências e falhas de cache, falhas L1d)
+#   PERF_REAL_SIZE      processos da carga em tempo real (padrão: 400)
+#   PERF_VIRTUAL_SIZE   processos da carga em tempo virtual (padrão: 200000)
+set -euo pipefail
+
+cd "$(dirname "$0")/.."
+
+KERNEL=./trabSO
+GENERATOR=./tools/workload_generator
+WORKDIR=bench/cargas
+EVENTS=${PERF_EVENTS:-"cycles,instructions,cache-references,cache-misses,L1-dcache-load-misses"}
+REAL_SIZE=${PERF_REAL_SIZE:-400}
+VIRTUAL_SIZE=${PERF_VIRTUAL_SIZE:-200000}
+CPUS=${1:-8}
+
+if ! command -v perf > /dev/null; then
+    echo "perf não encontrado (pacote linux-tools)" >&2
+    exit 1
+fi
+
+mkdir -p "$WORKDIR"
+
+# Processos curtos com várias threads e fatias de 1ms: muitos despachos e fatias simultâneas
+"$GENERATOR" -n "$REAL_SIZE" -p 2 -a poisson -r 5 -l uniform:20:120 -t uniform:1:8 -s 3 > "$WORKDIR/perf_real.txt"
+"$GENERATOR" -n "$VIRTUAL_SIZE" -p 7 -a poisson -r 2 -l exp:300 -t uniform:1:8 -s 3 > "$WORKDIR/perf_virtual.txt"
+
+echo "== tempo real: $REAL_SIZE processos, $CPUS CPUs, fatia de 1ms"
+perf stat -e "$EVENTS" "$KERNEL" --cpus "$CPUS" --slice 1 --binary-log "$WORKDIR/perf_real.txt" > /dev/null
+
+echo "== tempo virtual: $VIRTUAL_SIZE processos, $CPUS CPUs"
+perf stat -e "$EVENTS" "$KERNEL" --virtual --cpus "$CPUS" --binary-log "$WORKDIR/perf_virtual.txt" > /dev/null
+
+rm -f "$WORKDIR/perf_real.txt" "$WORKDIR/perf_virtual.txt"
@@ -0,0 +1,84 @@
+#!/usr/bin/env bash
+# Benchmark do escalonador: FCFS/RR/PRIORITY em várias CPUs e tamanhos de carga.
+# Mede tempo de parede, tempo de CPU (usuário/sistema) e custo por despacho,
+# para que regressões em scheduler.c apareçam entre execuções.
+#
+# Variáveis de ambiente:
+#   BENCH_SIZES      tamanhos das cargas em tempo virtual (padrão: "1000 10000 100000")
+#   BENCH_CPUS       número de CPUs (padrão: "1 4 16")
+#   BENCH_REAL_SIZE  processos da carga em tempo real, 0 desativa (padrão: 20)
+#   BENCH_SEED       semente do gerador (padrão: 42)
+set -euo pipefail
+
+cd "$(dirname "$0")/.."
+
+KERNEL=./trabSO
+GENERATOR=./tools/workload_generator
+WORKDIR=bench/cargas
+RESULTS=bench/resultados.csv
+
+SIZES=${BENCH_SIZES:-"1000 10000 100000"}
+CPUS=${BENCH_CPUS:-"1 4 16"}
+REAL_SIZE=${BENCH_REAL_SIZE:-20}
+SEED=${BENCH_SEED:-42}
+POLICIES="1 2 3"
+
+mkdir -p "$WORKDIR"
+echo "mode,policy,cpus,processes,wall_s,user_s,sys_s,dispatches,ns_per_dispatch" > "$RESULTS"
+
+policy_name() {
+    case $1 in
+        1) echo FCFS ;;
+        2) echo RR ;;
+        3) echo PRIORITY ;;
+    esac
+}
+
+# Executa uma configuração e acrescenta uma linha aos resultados
+# $1 = modo (virtual|real), $2 = política, $3 = CPUs, $4 = processos, $5 = carga
+run_case() {
+    local mode=$1 policy=$2 cpus=$3 size=$4 input=$5
+    local metrics="$WORKDIR/metricas.csv"
+    local flags=(--cpus "$cpus" --binary-log --metrics "$metrics")
+    [ "$mode" = virtual ] && flags+=(--virtual)
+
+    local TIMEFORMAT='%R %U %S'
+    local times
+    times=$( { time "$KERNEL" "${flags[@]}" "$input" > /dev/null; } 2>&1 | tail -n 1 )
+    read -r wall user sys <<< "$times"
+
+    local dispatches
+    dispatches=$(awk -F, '$1 == "dispatches" { print $2 }' "$metrics")
+    local ns_per_dispatch
+    ns_per_dispatch=$(awk -v u="$user" -v s="$sys" -v d="$dispatches" \
+        'BEGIN { printf "%.0f", (d > 0 ? (u + s) * 1e9 / d : 0) }')
+
+    echo "$mode,$(policy_name "$policy"),$cpus,$size,$wall,$user,$sys,$dispatches,$ns_per_dispatch" >> "$RESULTS"
+}
+
+# Tempo virtual: mede apenas o custo do escalonador, sem esperas reais
+for size in $SIZES; do
+    for policy in $POLICIES; do
+        input="$WORKDIR/virtual_${size}_${policy}.txt"
+        "$GENERATOR" -n "$size" -p "$policy" -a poisson -r 100 -s "$SEED" > "$input"
+        for cpus in $CPUS; do
+            run_case virtual "$policy" "$cpus" "$size" "$input"
+        done
+    done
+done
+
+# Tempo real: carga pequena com chegadas em rajadas, inclui as threads simuladas
+if [ "$REAL_SIZE" -gt 0 ]; then
+    for policy in $POLICIES; do
+        input="$WORKDIR/real_${REAL_SIZE}_${policy}.txt"
+        "$GENERATOR" -n "$REAL_SIZE" -p "$policy" -a bursty -b 5 -r 50 \
+            -l uniform:50:300 -s "$SEED" > "$input"
+        for cpus in 1 4; do
+            run_case real "$policy" "$cpus" "$REAL_SIZE" "$input"
+        done
+    done
+fi
+
+rm -f "$WORKDIR/metricas.csv"
+awk -F, '{ printf "%-8s %-9s %5s %10s %9s %9s %9s %11s %15s\n", $1, $2, $3, $4, $5, $6, $7, $8, $9 }' "$RESULTS"
+echo "Resultados em $RESULTS"
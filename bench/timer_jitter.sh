@@ -0,0 +1,43 @@
+#!/usr/bin/env bash
+# Atraso de entrega dos temporizadores do kernel (fins de fatia, chegadas e
+# despertares do escalonador) em tempo real, com os temporizadores no pool
+# compartilhado e com um executor fixado por CPU simulada (--pin-cpus).
+#
+# Uso: bench/timer_jitter.sh [CPUS] [NUCLEOS]
+#
+# NUCLEOS é a lista de núcleos do host para --pin-cpus (padrão: todos os disponíveis)
+#
+# Variáveis de ambiente:
+#   JITTER_SIZE     processos da carga (padrão: 80)
+#   JITTER_RUNS     execuções de cada modo (padrão: 3)
+set -euo pipefail
+
+cd "$(dirname "$0")/.."
+
+KERNEL=./trabSO
+GENERATOR=./tools/workload_generator
+WORKDIR=bench/cargas
+SIZE=${JITTER_SIZE:-80}
+RUNS=${JITTER_RUNS:-3}
+CPUS=${1:-4}
+CORES=${2:-"0-$(($(nproc) - 1))"}
+
+mkdir -p "$WORKDIR"
+
+# Processos curtos com várias threads: muitas fatias de 50ms vencendo juntas
+"$GENERATOR" -n "$SIZE" -p 2 -a poisson -r 40 -l uniform:100:800 -t uniform:1:4 -s 5 > "$WORKDIR/jitter.txt"
+
+echo "modo,execucao,media_us,p50_us,p90_us,p99_us,max_us"
+for mode in pool fixado; do
+    pin=()
+    if [ "$mode" = fixado ]; then
+        pin=(--pin-cpus "$CORES")
+    fi
+    for run in $(seq 1 "$RUNS"); do
+        "$KERNEL" --cpus "$CPUS" "${pin[@]}" --metrics "$WORKDIR/jitter.csv" "$WORKDIR/jitter.txt" > /dev/null
+        row=$(grep '^timer_jitter_us,' "$WORKDIR/jitter.csv" | cut -d, -f2-)
+        echo "$mode,$run,$row"
+    done
+done
+
+rm -f "$WORKDIR/jitter.txt" "$WORKDIR/jitter.csv"
@@ -0,0 +1,41 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <pthread.h>
+
+// Bloco de memória da arena
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;
+    size_t size;
+    size_t used;
+} ArenaBlock;
+
+// Arena: alocação por incremento em blocos grandes, liberada de uma só vez
+typedef struct {
+    ArenaBlock* blocks;
+    size_t block_size;
+    size_t total_bytes;     // Bytes reservados em blocos
+} Arena;
+
+// Slab: objetos de tamanho fixo sobre uma arena, com lista de livres
+typedef struct {
+    Arena* arena;
+    size_t object_size;
+    void* free_list;
+    pthread_mutex_t mutex;
+} Slab;
+
+// Funções da arena
+Arena* create_arena(size_t block_size);
+void* arena_alloc(Arena* arena, size_t size);
+void* arena_alloc_aligned(Arena* arena, size_t size, size_t alignment);
+void destroy_arena(Arena* arena);
+
+// Funções do slab
+Slab* create_slab(size_t object_size, size_t objects_per_block);
+void* slab_alloc(Slab* slab);
+void slab_free(Slab* slab, void* object);
+void destroy_slab(Slab* slab);
+
+#endif
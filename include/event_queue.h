@@ -0,0 +1,42 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include "pcb.h"
+#include <stdbool.h>
+
+// Tipos de evento da simulação em tempo virtual
+// A ordem do enum define o desempate entre eventos no mesmo instante:
+// fatias que terminam junto com uma chegada são contabilizadas antes dela
+typedef enum {
+    EVENT_SLICE_END,
+    EVENT_COMPLETION,
+    EVENT_ARRIVAL,
+    EVENT_QUANTUM_EXPIRY
+} EventType;
+
+// Evento agendado
+typedef struct {
+    long time;
+    long seq;
+    EventType type;
+    PCB* pcb;
+    int epoch;
+} Event;
+
+// Fila de eventos (heap mínimo por tempo, tipo e ordem de inserção)
+typedef struct {
+    Event* events;
+    int count;
+    int capacity;
+    long next_seq;
+} EventQueue;
+
+// Funções da fila de eventos
+EventQueue* create_event_queue();
+void destroy_event_queue(EventQueue* queue);
+void push_event(EventQueue* queue, long time, EventType type, PCB* pcb, int epoch);
+bool pop_event(EventQueue* queue, Event* event);
+bool is_event_queue_empty(EventQueue* queue);
+long peek_event_time(EventQueue* queue);
+
+#endif
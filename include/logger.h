@@ -2,11 +2,53 @@
 #define LOGGER_H
 
 #include <sys/time.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define LOG_TEXT_FILE "log_execucao_minikernel.txt"
+#define LOG_BINARY_FILE "log_execucao_minikernel.bin"
+#define LOG_NO_CPU -1
+
+// Tipos de registro do log
+typedef enum {
+    LOG_DISPATCH,
+    LOG_FINISHED,
+    LOG_SCHEDULER_DONE,
+    LOG_DEADLINE_MISS       // Término após o prazo; detail = atraso em ms
+} LogRecordType;
+
+// Detalhe exibido junto ao despacho
+#define LOG_SHOW_QUANTUM  0x1
+#define LOG_SHOW_PRIORITY 0x2
+
+// Registro binário: o caminho crítico apenas copia campos, a formatação
+// acontece na thread escritora (ou offline, com --decode-log)
+typedef struct {
+    int64_t time_ms;
+    int32_t pid;
+    int32_t cpu;        // LOG_NO_CPU em monoprocessador
+    int32_t detail;     // Quantum ou prioridade, conforme flags, ou atraso
+    uint8_t type;
+    uint8_t policy;
+    uint8_t flags;
+    uint8_t reserved;
+} LogRecord;
 
 // Funções de log
-void add_to_log(const char* message);
-void save_log_to_file();
+bool start_logger(bool binary);
+void stop_logger();
+void log_event(LogRecordType type, int policy, int pid, int cpu, int flags, int detail);
+void format_log_record(const LogRecord* record, char* buffer, size_t size);
+bool decode_log_file(const char* filename, FILE* out);
 long get_current_time_ms();
+long get_monotonic_time_us();
+long monotonic_deadline_us(long time_ms);
+
+// Relógio virtual
+void enable_virtual_clock();
+bool is_virtual_clock_enabled();
+void advance_virtual_clock(long time_ms);
 
 // Variáveis globais de tempo
 extern struct timeval start_time_global;
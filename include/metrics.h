@@ -0,0 +1,10 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdbool.h>
+
+// Relatório de métricas ao final da execução
+// Formato pela extensão do arquivo: .json gera JSON, qualquer outra gera CSV
+bool write_metrics_report(const char* filename);
+
+#endif
@@ -1,9 +1,10 @@
 #ifndef PCB_H
 #define PCB_H
 
-#include <pthread.h>
 #include <stdbool.h>
 
+#define CACHE_LINE_SIZE 64
+
 // Estados do processo
 typedef enum {
     READY,
@@ -11,24 +12,68 @@ typedef enum {
     FINISHED
 } ProcessState;
 
-// Estrutura BCP (Bloco de Controle de Processo)
+struct ReadyQueue;
+struct TCB;
+
+// Métricas de escalonamento do processo (ms; -1 = ainda não ocorreu)
 typedef struct {
+    long arrival_ms;            // Primeira entrada na fila de prontos
+    long first_dispatch_ms;
+    long completion_ms;
+    long ready_since_ms;        // Entrada atual na fila de prontos (-1 fora dela)
+    long total_wait_ms;         // Tempo acumulado na fila de prontos
+    long cpu_ms;                // Tempo ocupando CPUs (soma entre as CPUs)
+    int preemptions;
+    int migrations;
+    int migration_penalty_ms;   // Trabalho somado ao restante pelas migrações
+    int last_cpu;
+} ProcessMetrics;
+
+// Estrutura BCP (Bloco de Controle de Processo), em linhas de cache separadas
+// pelo padrão de acesso; alinhada, processos vizinhos em pcb_list nunca dividem
+// uma linha
+typedef struct PCB {
+    // Linha 1: chaves lidas e escritas a cada decisão do escalonador
+    int priority;
+    int queue_level;        // Balde na fila de prontos: prioridade, ou nível no MLFQ
+    int cpu_count;          // CPUs simuladas ocupadas pelo processo
+    int heap_index;         // Posição no heap ordenado da fila de prontos
     int pid;
+    int dispatch_remaining; // Tempo restante no início do despacho atual
+    int start_time;
+    long sort_key;          // Chave do heap ordenado (tempo restante, tempo virtual ou prazo)
+    long sort_seq;          // Ordem de entrada, desempate entre chaves iguais
+    long quantum_end_ms;    // Fim do quantum do despacho atual (-1 = sem quantum)
+    long vruntime;          // Tempo virtual: vruntime (CFS) ou passo acumulado (stride)
+    
+    // Linha 2: encadeamento intrusivo na fila de prontos e parâmetros da política
+    struct ReadyQueue* queue;       // Fila que contém o processo (NULL se fora)
+    struct PCB* queue_prev;         // Ordem de chegada
+    struct PCB* queue_next;
+    struct PCB* level_prev;         // Balde da prioridade
+    struct PCB* level_next;
+    long deadline_ms;               // Prazo absoluto, definido na chegada (-1 = sem prazo)
+    int tickets;                    // Bilhetes do stride/loteria (0 = derivado da prioridade)
+    int num_threads;
     int process_len;
+    int relative_deadline;          // Prazo relativo à chegada (-1 = sem prazo)
+    
+    // Linha 3: o que os workers das fatias escrevem, sem trava (operações atômicas;
+    // transições a partir de RUNNING por CAS), longe das chaves do escalonador
+    ProcessState state __attribute__((aligned(CACHE_LINE_SIZE)));
     int remaining_time;
-    int priority;
-    int num_threads;
-    int start_time;
-    ProcessState state;
-    pthread_mutex_t mutex;
-    pthread_cond_t cv;
-    pthread_t *thread_ids;
-} PCB;
+    struct TCB** threads;   // TCBs do processo (NULL em tempo virtual)
+    
+    // Linha 4: métricas, escritas apenas nas transições de estado
+    ProcessMetrics metrics __attribute__((aligned(CACHE_LINE_SIZE)));
+} __attribute__((aligned(CACHE_LINE_SIZE))) PCB;
 
 // Funções para gerenciar PCB
 PCB* create_pcb(int pid, int process_len, int priority, int num_threads, int start_time);
 void destroy_pcb(PCB* pcb);
-void initialize_pcb(PCB* pcb, int pid, int process_len, int priority, int num_threads, int start_time);
+// threads pertence ao chamador (pode ser NULL quando não há threads simuladas)
+void initialize_pcb(PCB* pcb, int pid, int process_len, int priority, int num_threads, int start_time,
+                    struct TCB** threads);
 void cleanup_pcb(PCB* pcb);
 
 #endif
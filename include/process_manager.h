@@ -3,17 +3,39 @@
 
 #include "pcb.h"
 #include "tcb.h"
+#include <stdbool.h>
+#include <stddef.h>
 
 #define THREAD_EXEC_TIME_MS 500
+#define THREAD_SLICE_MS 50  // Padrão da fatia das threads simuladas (--slice)
+
+// Leitura da carga de entrada (relatada nas métricas)
+typedef struct {
+    size_t bytes;
+    long load_us;           // Do início da leitura até os PCBs prontos
+    bool binary;
+} InputStats;
+
+// Chegadas em ordem de (start_time, pid), intercalando as sequências de pcb_list
+// já ordenadas por um heap: memória proporcional ao número de sequências
+typedef struct {
+    struct ArrivalRun* runs;
+    int count;
+} ArrivalStream;
 
 // Funções de gerenciamento de processos
 void read_input(const char* filename);
-void* process_thread_function(void* arg);
-void* process_generator_thread_function(void* arg);
+void activate_process_threads(PCB* pcb);
+void start_process_arrivals();
+bool open_arrival_stream(ArrivalStream* stream);
+PCB* peek_arrival(const ArrivalStream* stream);
+PCB* next_arrival(ArrivalStream* stream);
+void close_arrival_stream(ArrivalStream* stream);
 void cleanup_resources();
 
 // Variáveis globais dos processos
 extern PCB* pcb_list;
 extern int num_processes;
+extern InputStats input_stats;
 
 #endif
@@ -3,15 +3,23 @@
 
 #include "pcb.h"
 #include <stdbool.h>
+#include <stdint.h>
 #include <pthread.h>
 
-#define MAX_PROCESSES 100
+#define PRIORITY_LEVELS 64  // Níveis (queue_level) fora de [0, 63] são limitados aos extremos
 
-// Estrutura da fila de prontos
-typedef struct {
-    PCB* processes[MAX_PROCESSES];
-    int front;
-    int rear;
+// Estrutura da fila de prontos (sem limite de tamanho)
+// Lista FIFO de chegada + um balde FIFO por nível (queue_level), com bitmap dos baldes não vazios,
+// + um heap mínimo por (sort_key, ordem de entrada)
+typedef struct ReadyQueue {
+    PCB* head;
+    PCB* tail;
+    PCB* level_head[PRIORITY_LEVELS];
+    PCB* level_tail[PRIORITY_LEVELS];
+    uint64_t level_mask;
+    PCB** heap;
+    int heap_capacity;
+    long next_seq;
     int count;
     pthread_mutex_t mutex;
 } ReadyQueue;
@@ -21,10 +29,15 @@ ReadyQueue* create_ready_queue();
 void destroy_ready_queue(ReadyQueue* queue);
 void enqueue_process(ReadyQueue* queue, PCB* process);
 PCB* dequeue_process(ReadyQueue* queue);
+PCB* dequeue_process_tail(ReadyQueue* queue);
+int ready_queue_size(ReadyQueue* queue);
 bool is_queue_empty(ReadyQueue* queue);
 void remove_process_from_queue(ReadyQueue* queue, PCB* process);
 PCB* find_highest_priority_process(ReadyQueue* queue);
-PCB* find_highest_priority_process_without_removing(ReadyQueue* queue);
 PCB* ready_queue_peek_highest_priority(ReadyQueue* queue);
+void ready_queue_reset_levels(ReadyQueue* queue);
+PCB* find_min_key_process(ReadyQueue* queue);
+PCB* ready_queue_peek_min_key(ReadyQueue* queue);
+void ready_queue_for_each(ReadyQueue* queue, void (*visit)(PCB* process, void* arg), void* arg);
 
 #endif
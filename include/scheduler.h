@@ -5,23 +5,117 @@
 #include "ready_queue.h"
 #include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 
-#define MAX_LOG_SIZE 10000
-#define QUANTUM_MS 500
+#define QUANTUM_MS 500       // Padrão do Round Robin (--quantum)
+#define QUANTUM_GRACE_MS 10  // Tolerância para a fatia que termina junto com o quantum
+#define BALANCE_INTERVAL_MS 100
+#define ANY_CPU -1
+#define NO_AFFINITY -1       // Sem preferência pela última CPU (--affinity desligado)
+
+// MLFQ: nível 0 é o mais prioritário; o quantum dobra a cada nível
+#define MLFQ_LEVELS 4
+#define MLFQ_BASE_QUANTUM_MS 100
+#define MLFQ_BOOST_INTERVAL_MS 1000  // Período do retorno de todos os processos ao nível 0
+
+// CFS: a latência alvo é dividida entre os processos executáveis pelo peso;
+// a fatia nunca é menor que a de uma thread e é múltipla dela
+#define CFS_TARGET_LATENCY_MS 300
+#define CFS_NICE_0_WEIGHT 1024
+
+// Quantum adaptativo do RR (--adaptive-quantum): próximo da estimativa do serviço
+// dos processos, limitado para que a fila de cada CPU execute dentro da latência alvo
+#define ADAPTIVE_TARGET_LATENCY_MS 2000
+
+// Stride e loteria: CPU proporcional aos bilhetes, em quanta fixos. A prioridade
+// define os bilhetes padrão (1 = 500 ... 5 = 100), substituíveis pela diretiva "tickets"
+#define STRIDE_QUANTUM_MS 100
+#define STRIDE_ONE (1L << 20)           // Passo de um processo com um único bilhete
+#define TICKETS_PER_PRIORITY_LEVEL 100
 
 // Políticas de escalonamento
 typedef enum {
     FCFS = 1,
     RR = 2,
-    PRIORITY = 3
+    PRIORITY = 3,
+    SJF = 4,        // Menor tempo restante primeiro, sem preempção
+    SRTF = 5,       // Menor tempo restante primeiro, preempta na chegada de um mais curto
+    MLFQ = 6,       // Filas multinível com realimentação e boost periódico
+    CFS = 7,        // Menor tempo virtual (vruntime) ponderado pela prioridade
+    EDF = 8,        // Prazo absoluto mais cedo primeiro, preempta na chegada
+    STRIDE = 9,     // Menor passo acumulado; o passo avança inversamente aos bilhetes
+    LOTTERY = 10    // Sorteio proporcional aos bilhetes a cada quantum
 } SchedulerType;
 
+// Teste de admissão do EDF sobre os processos com prazo
+typedef struct {
+    int deadline_processes;
+    double peak_density;    // Maior soma de densidades (custo/prazo) de processos ativos juntos
+    double max_density;     // Maior densidade individual
+    double bound;           // Densidade garantida pelas CPUs
+    bool admitted;
+} EDFAdmission;
+
+// Estado de uma CPU simulada (uma linha de cache por CPU)
+typedef struct {
+    PCB* current_process;
+    ReadyQueue* run_queue;  // Fila de prontos local da CPU
+    
+    // Métricas da CPU
+    long busy_ms;           // Tempo total ocupada
+    long busy_since_ms;     // Início da ocupação atual
+    long context_switches;  // Trocas para um processo diferente do anterior
+    long dispatches;        // Processos retirados da fila de prontos para esta CPU
+    int last_pid;
+} __attribute__((aligned(CACHE_LINE_SIZE))) CPUState;
+
+// Quanta concedidos nos despachos e quantos foram esgotados (devolvendo a CPU)
+typedef struct {
+    long dispatches;
+    long total_ms;
+    long min_ms;
+    long max_ms;
+    long expirations;
+} QuantumStats;
+
+// Latência de cada preempção: do instante em que ela passou a ser devida (chegada
+// do processo que preempta, ou despacho da vítima se ele já esperava) até o
+// despacho dele na CPU liberada
+typedef struct {
+    PCB** pending;          // Por CPU: processo que a desalocou, até o próximo despacho nela
+    long* due_ms;           // Por CPU: instante em que essa preempção passou a ser devida
+    long* samples_ms;
+    long count;
+    long capacity;
+    long partial;           // Preempções que tiraram uma só CPU de um processo expandido
+} PreemptionStats;
+
 // Estrutura para o escalonador
 typedef struct {
-    ReadyQueue* ready_queue;
     SchedulerType scheduler_type;
     int num_cpus;
-    PCB* current_process[2]; // Para até 2 CPUs
+    long quantum_ms;        // Quantum do Round Robin (--quantum)
+    long slice_ms;          // Fatia de execução de cada thread simulada (--slice)
+    bool adaptive_quantum;
+    int affinity_tolerance; // Processos a mais tolerados na fila da última CPU (--affinity)
+    long migration_cost_ms; // Aquecimento somado ao trabalho a cada migração (--migration-cost)
+    bool bind_threads;      // Threads só avançam nas CPUs do processo (--bind-threads)
+    bool gang_scheduling;   // Processos recebem todas as CPUs das suas threads de uma vez (--gang)
+    long gang_backfills;    // Gangs menores despachados à frente do primeiro da fila
+    long burst_estimate_ms; // Média exponencial do serviço dos processos finalizados
+    QuantumStats quantum_stats;
+    PreemptionStats preemption_stats;
+    CPUState* cpus;         // num_cpus entradas
+    uint64_t* idle_mask;    // Bit ligado = CPU livre
+    int idle_count;
+    long cpu_changes;       // Incrementado a cada alocação/liberação de CPU
+    int ready_count;        // Total de processos nas filas locais
+    long last_balance_ms;
+    long last_boost_ms;
+    long cfs_total_weight;  // Soma dos pesos dos processos chegados e não finalizados
+    long min_vruntime;      // Referência de tempo virtual para chegadas (CFS/stride), nunca recua
+    long lottery_clock;     // Chave do último sorteado (loteria)
+    int pending_events;     // Chegadas/términos sinalizados e ainda não tratados
     bool generator_done;
     pthread_cond_t scheduler_cv;
     pthread_mutex_t scheduler_mutex;
@@ -32,8 +126,31 @@ Scheduler* create_scheduler(int num_cpus, SchedulerType type);
 void destroy_scheduler(Scheduler* scheduler);
 void initialize_scheduler(int num_cpus);
 void* scheduler_thread_function(void* arg);
-void handle_monoprocessor_execution(PCB* process, const char* policy_names[], char* log_msg);
-void handle_multiprocessor_execution(const char* policy_names[], char* log_msg);
+void enqueue_ready_process(PCB* process, int cpu);
+bool has_ready_processes();
+PCB* select_next_process(int cpu);
+PCB* peek_next_process(int cpu);
+bool is_preemptive_policy();
+bool should_preempt(PCB* candidate, PCB* running);
+void mark_preemption(int cpu, PCB* candidate);
+long process_quantum_ms(PCB* process);
+long process_tickets(const PCB* process);
+int process_running_threads(const PCB* process);
+bool multiprocessor_quantum_enabled();
+void demote_process(PCB* process);
+void balance_run_queues();
+void assign_process_to_cpu(int cpu, PCB* process);
+void release_cpu(int cpu);
+int next_idle_cpu(int from);
+const char* scheduler_policy_name(int type);
+void edf_admission_test(EDFAdmission* result);
+void log_monoprocessor_dispatch(PCB* process);
+void log_process_finished(PCB* process);
+void handle_monoprocessor_execution(PCB* process);
+void handle_multiprocessor_execution();
+void schedule_multiprocessor();
+void notify_scheduler();
+void wait_for_scheduler_event(long deadline_ms);
 
 // Variáveis globais do escalonador
 extern Scheduler* scheduler;
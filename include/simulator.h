@@ -0,0 +1,9 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+// Simulação por eventos discretos em tempo virtual
+// Substitui as threads do gerador, do escalonador e dos processos por uma
+// fila de eventos (chegadas, fim de fatia, término e fim de quantum)
+void run_virtual_simulation();
+
+#endif
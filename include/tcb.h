@@ -2,15 +2,22 @@
 #define TCB_H
 
 #include "pcb.h"
+#include "timer_wheel.h"
+#include <stdbool.h>
 
 // Estrutura TCB (Task Control Block)
-typedef struct {
+// Não há pthread por TCB: a thread simulada é uma tarefa do pool de workers
+typedef struct TCB {
     PCB* pcb;
     int thread_index;
+    bool armed;                 // Possui fatia agendada no pool (atômico; falso = estacionada)
+    long slice_deadline_us;     // Fim da fatia atual (CLOCK_MONOTONIC)
+    Timer slice_timer;          // Temporizador do fim da fatia na roda do pool
 } TCB;
 
 // Funções para gerenciar TCB
 TCB* create_tcb(PCB* pcb, int thread_index);
 void destroy_tcb(TCB* tcb);
+void destroy_tcb_allocator();
 
 #endif
@@ -0,0 +1,62 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Roda de temporizadores hierárquica: TIMER_WHEEL_LEVELS níveis de
+// TIMER_WHEEL_SLOTS posições, cada nível com resolução TIMER_WHEEL_SLOTS vezes
+// maior que o anterior (1ms, 64ms, ~4s, ~4min). Inserir e cancelar são O(1);
+// ao virar um nível, a posição seguinte do nível acima desce (cascata).
+// Sem sincronização própria: o pool de workers a protege com seu mutex
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_TICK_US 1000
+
+#define TIMER_IDLE -1       // Fora da roda
+#define TIMER_EXPIRED -2    // Vencido, aguardando um worker
+
+struct Timer;
+typedef void (*TimerCallback)(struct Timer* timer);
+
+// Temporizador intrusivo (embutido no dono, sem alocação)
+typedef struct Timer {
+    struct Timer* prev;
+    struct Timer* next;
+    long expires_us;        // CLOCK_MONOTONIC
+    int level;              // Nível na roda, TIMER_IDLE ou TIMER_EXPIRED
+    int slot;
+    TimerCallback callback;
+    void* data;
+} Timer;
+
+typedef struct {
+    Timer* head;
+    Timer* tail;
+} TimerList;
+
+typedef struct {
+    TimerList slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    uint64_t occupied[TIMER_WHEEL_LEVELS];  // Bit por posição não vazia
+    TimerList expired;                      // Vencidos, em ordem de vencimento
+    long current_tick;                      // Próximo tick ainda não processado
+    long count;                             // Temporizadores na roda (sem os vencidos)
+} TimerWheel;
+
+void init_timer(Timer* timer, TimerCallback callback, void* data);
+bool timer_pending(const Timer* timer);
+
+void init_timer_wheel(TimerWheel* wheel, long now_us);
+void timer_wheel_add(TimerWheel* wheel, Timer* timer, long expires_us);
+void timer_wheel_cancel(TimerWheel* wheel, Timer* timer);
+
+// Move para a lista de vencidos tudo que vence até now_us
+void timer_wheel_advance(TimerWheel* wheel, long now_us);
+Timer* timer_wheel_pop_expired(TimerWheel* wheel);
+
+// Instante (us) em que a roda precisa ser avançada de novo: o vencimento mais
+// próximo ou a próxima cascata que pode trazê-lo; -1 se vazia, 0 se há vencidos
+long timer_wheel_next_us(const TimerWheel* wheel);
+
+#endif
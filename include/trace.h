@@ -0,0 +1,49 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Carga de processos em texto (formato de read_input) ou binário compacto.
+// Binário: TraceHeader seguido de num_processes TraceRecord, na ordem de bytes
+// da máquina; o arquivo é mapeado e os registros lidos sem cópia
+#define TRACE_BINARY_MAGIC "MKTRC01"
+
+typedef struct {
+    char magic[8];          // TRACE_BINARY_MAGIC com o terminador
+    int32_t num_processes;
+    int32_t policy;
+} TraceHeader;
+
+typedef struct {
+    int32_t process_len;
+    int32_t priority;
+    int32_t num_threads;
+    int32_t start_time;
+    int32_t relative_deadline;  // -1 = sem prazo (diretiva "deadline")
+    int32_t tickets;            // 0 = derivado da prioridade (diretiva "tickets")
+} TraceRecord;
+
+typedef struct {
+    int num_processes;
+    int policy;
+    const TraceRecord* records; // num_processes entradas
+    size_t bytes;               // Tamanho do arquivo
+    bool binary;
+    
+    // Privado: mapeamento do arquivo e registros analisados do texto
+    void* mapping;
+    TraceRecord* parsed;
+} Trace;
+
+// Carrega o arquivo, detectando o formato pelo cabeçalho. Em erro, grava em
+// error a causa (com a linha no texto ou o registro no binário) e retorna false
+bool load_trace(const char* filename, Trace* trace, char* error, size_t error_size);
+void free_trace(Trace* trace);
+
+bool write_binary_trace(const char* filename, const Trace* trace);
+bool write_text_trace(FILE* out, const Trace* trace);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "timer_wheel.h"
+#include <stdbool.h>
+
+#define MAX_HOST_CORES 1024  // Núcleos aceitos em --pin-cpus
+
+// Pool fixo de workers (modelo M:N): as threads simuladas não têm pthread nem
+// pilha próprias. Os workers dormem até o próximo vencimento da roda de
+// temporizadores do kernel (fins de fatia, chegadas e o despertar do
+// escalonador) e executam o callback de cada temporizador vencido
+bool start_worker_pool(int num_workers);
+
+// Modo fixado (--pin-cpus): cada CPU simulada ganha um executor com roda própria,
+// preso por sched_setaffinity a um núcleo do conjunto (em rodízio), e as fatias
+// das threads de um processo executam no executor da sua CPU. Falso se algum
+// núcleo não está disponível para o processo
+bool start_cpu_executors(int num_cpus, const int* host_cores, int num_cores);
+
+void stop_worker_pool();
+void add_timer(Timer* timer, long expires_us);
+void add_cpu_timer(int cpu, Timer* timer, long expires_us);
+void cancel_timer(Timer* timer);
+int host_worker_count();
+
+// Atraso de entrega dos temporizadores: do vencimento até o worker retirá-lo da
+// roda. Preenchido por stop_worker_pool, uma amostra por temporizador executado
+typedef struct {
+    long* samples_us;
+    long count;
+    int pinned_cpus;        // Executores fixados (0 = sem --pin-cpus)
+} TimerJitter;
+
+void free_timer_jitter();
+
+extern TimerJitter timer_jitter;
+
+#endif
@@ -0,0 +1,141 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+#define ARENA_ALIGNMENT 16
+
+static size_t align_up(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+// Cabeçalho alinhado: os dados começam logo após ele
+static char* block_data(ArenaBlock* block) {
+    return (char*)block + align_up(sizeof(ArenaBlock));
+}
+
+static ArenaBlock* create_block(size_t size) {
+    ArenaBlock* block = malloc(align_up(sizeof(ArenaBlock)) + size);
+    if (!block) return NULL;
+    
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+Arena* create_arena(size_t block_size) {
+    Arena* arena = malloc(sizeof(Arena));
+    if (!arena) return NULL;
+    
+    arena->blocks = NULL;
+    arena->block_size = align_up(block_size);
+    arena->total_bytes = 0;
+    return arena;
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+    if (!arena) return NULL;
+    
+    size = align_up(size);
+    ArenaBlock* block = arena->blocks;
+    
+    if (!block || block->size - block->used < size) {
+        // Alocações grandes ganham um bloco exclusivo, atrás do bloco corrente
+        if (size > arena->block_size / 4) {
+            ArenaBlock* large = create_block(size);
+            if (!large) return NULL;
+            
+            large->used = size;
+            arena->total_bytes += size;
+            if (block) {
+                large->next = block->next;
+                block->next = large;
+            } else {
+                arena->blocks = large;
+            }
+            return block_data(large);
+        }
+        
+        block = create_block(arena->block_size);
+        if (!block) return NULL;
+        
+        block->next = arena->blocks;
+        arena->blocks = block;
+        arena->total_bytes += block->size;
+    }
+    
+    void* data = block_data(block) + block->used;
+    block->used += size;
+    return data;
+}
+
+// alignment: potência de 2; a folga para alinhar o início fica sem uso
+void* arena_alloc_aligned(Arena* arena, size_t size, size_t alignment) {
+    if (alignment <= ARENA_ALIGNMENT) return arena_alloc(arena, size);
+    
+    char* data = arena_alloc(arena, size + alignment - ARENA_ALIGNMENT);
+    if (!data) return NULL;
+    return (void*)(((uintptr_t)data + alignment - 1) & ~(uintptr_t)(alignment - 1));
+}
+
+void destroy_arena(Arena* arena) {
+    if (!arena) return;
+    
+    ArenaBlock* block = arena->blocks;
+    while (block) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+Slab* create_slab(size_t object_size, size_t objects_per_block) {
+    Slab* slab = malloc(sizeof(Slab));
+    if (!slab) return NULL;
+    
+    // Objeto livre guarda o ponteiro para o próximo livre
+    if (object_size < sizeof(void*)) {
+        object_size = sizeof(void*);
+    }
+    slab->object_size = align_up(object_size);
+    slab->arena = create_arena(slab->object_size * objects_per_block);
+    if (!slab->arena) {
+        free(slab);
+        return NULL;
+    }
+    slab->free_list = NULL;
+    pthread_mutex_init(&slab->mutex, NULL);
+    return slab;
+}
+
+void* slab_alloc(Slab* slab) {
+    if (!slab) return NULL;
+    
+    pthread_mutex_lock(&slab->mutex);
+    void* object = slab->free_list;
+    if (object) {
+        slab->free_list = *(void**)object;
+    } else {
+        object = arena_alloc(slab->arena, slab->object_size);
+    }
+    pthread_mutex_unlock(&slab->mutex);
+    return object;
+}
+
+void slab_free(Slab* slab, void* object) {
+    if (!slab || !object) return;
+    
+    pthread_mutex_lock(&slab->mutex);
+    *(void**)object = slab->free_list;
+    slab->free_list = object;
+    pthread_mutex_unlock(&slab->mutex);
+}
+
+void destroy_slab(Slab* slab) {
+    if (!slab) return;
+    
+    destroy_arena(slab->arena);
+    pthread_mutex_destroy(&slab->mutex);
+    free(slab);
+}
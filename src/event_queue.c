@@ -0,0 +1,101 @@
+#include "event_queue.h"
+#include <stdlib.h>
+
+#define INITIAL_EVENT_CAPACITY 64
+
+static bool event_before(const Event* a, const Event* b) {
+    if (a->time != b->time) return a->time < b->time;
+    if (a->type != b->type) return a->type < b->type;
+    return a->seq < b->seq;
+}
+
+static void swap_events(Event* a, Event* b) {
+    Event temp = *a;
+    *a = *b;
+    *b = temp;
+}
+
+EventQueue* create_event_queue() {
+    EventQueue* queue = malloc(sizeof(EventQueue));
+    if (!queue) return NULL;
+
+    queue->events = malloc(INITIAL_EVENT_CAPACITY * sizeof(Event));
+    if (!queue->events) {
+        free(queue);
+        return NULL;
+    }
+    queue->count = 0;
+    queue->capacity = INITIAL_EVENT_CAPACITY;
+    queue->next_seq = 0;
+    return queue;
+}
+
+void destroy_event_queue(EventQueue* queue) {
+    if (!queue) return;
+
+    free(queue->events);
+    free(queue);
+}
+
+void push_event(EventQueue* queue, long time, EventType type, PCB* pcb, int epoch) {
+    if (!queue) return;
+
+    if (queue->count == queue->capacity) {
+        int new_capacity = queue->capacity * 2;
+        Event* events = realloc(queue->events, new_capacity * sizeof(Event));
+        if (!events) return;
+        queue->events = events;
+        queue->capacity = new_capacity;
+    }
+
+    int i = queue->count++;
+    queue->events[i].time = time;
+    queue->events[i].seq = queue->next_seq++;
+    queue->events[i].type = type;
+    queue->events[i].pcb = pcb;
+    queue->events[i].epoch = epoch;
+
+    // Subir no heap
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!event_before(&queue->events[i], &queue->events[parent])) break;
+        swap_events(&queue->events[i], &queue->events[parent]);
+        i = parent;
+    }
+}
+
+bool pop_event(EventQueue* queue, Event* event) {
+    if (!queue || queue->count == 0) return false;
+
+    *event = queue->events[0];
+    queue->events[0] = queue->events[--queue->count];
+
+    // Descer no heap
+    int i = 0;
+    while (true) {
+        int left = 2 * i + 1;
+        int right = left + 1;
+        int smallest = i;
+
+        if (left < queue->count && event_before(&queue->events[left], &queue->events[smallest])) {
+            smallest = left;
+        }
+        if (right < queue->count && event_before(&queue->events[right], &queue->events[smallest])) {
+            smallest = right;
+        }
+        if (smallest == i) break;
+
+        swap_events(&queue->events[i], &queue->events[smallest]);
+        i = smallest;
+    }
+    return true;
+}
+
+bool is_event_queue_empty(EventQueue* queue) {
+    return !queue || queue->count == 0;
+}
+
+long peek_event_time(EventQueue* queue) {
+    if (!queue || queue->count == 0) return -1;
+    return queue->events[0].time;
+}
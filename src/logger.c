@@ -1,39 +1,301 @@
 #include "logger.h"
+#include "scheduler.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <sys/time.h>
 #include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <time.h>
 
-#define MAX_LOG_SIZE 10000
+#define LOG_RING_SIZE 16384  // Potência de 2
+#define LOG_RING_MASK (LOG_RING_SIZE - 1)
+#define LOG_STREAM_BUFFER 65536
+#define LOG_WAKE_THRESHOLD (LOG_RING_SIZE / 2)  // Ocupação que acorda a escritora
+#define LOG_FLUSH_INTERVAL_MS 50                // Período máximo sem descarregar o log
+
+static const char LOG_BINARY_MAGIC[8] = "MKLOG01";
 
 struct timeval start_time_global;
-static char log_buffer[MAX_LOG_SIZE];
-static int log_index = 0;
-static pthread_mutex_t log_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Fila MPSC limitada sem locks (sequência por posição): produtores reservam
+// uma posição com CAS em tail e publicam o registro; a ordem do log é a ordem
+// de reserva. A thread escritora consome em head e grava no arquivo.
+typedef struct {
+    size_t sequence;
+    LogRecord record;
+} LogSlot;
+
+typedef struct {
+    LogSlot slots[LOG_RING_SIZE];
+    size_t tail __attribute__((aligned(CACHE_LINE_SIZE)));
+    size_t head __attribute__((aligned(CACHE_LINE_SIZE)));
+} LogRing;
+
+static LogRing* log_ring = NULL;
+static FILE* log_file = NULL;
+static bool log_binary = false;
+static pthread_t writer_thread;
+
+// Espera da thread escritora quando a fila está vazia
+static pthread_mutex_t writer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t writer_cv = PTHREAD_COND_INITIALIZER;
+static int writer_sleeping = 0;
+static bool writer_stop = false;
+
+// Relógio virtual (modo de simulação por eventos discretos)
+static bool virtual_clock_enabled = false;
+static long virtual_time_ms = 0;
+
+void enable_virtual_clock() {
+    virtual_clock_enabled = true;
+    virtual_time_ms = 0;
+}
+
+bool is_virtual_clock_enabled() {
+    return virtual_clock_enabled;
+}
+
+void advance_virtual_clock(long time_ms) {
+    if (time_ms > virtual_time_ms) {
+        virtual_time_ms = time_ms;
+    }
+}
 
 long get_current_time_ms() {
+    if (virtual_clock_enabled) {
+        return virtual_time_ms;
+    }
+    
     struct timeval current_time;
     gettimeofday(&current_time, NULL);
-    return (current_time.tv_sec - start_time_global.tv_sec) * 1000 + 
+    return (current_time.tv_sec - start_time_global.tv_sec) * 1000 +
            (current_time.tv_usec - start_time_global.tv_usec) / 1000;
 }
 
-void add_to_log(const char* message) {
-    pthread_mutex_lock(&log_mutex);
-    int len = strlen(message);
-    if (log_index + len + 1 < MAX_LOG_SIZE) {
-        strcpy(log_buffer + log_index, message);
-        log_index += len;
-        log_buffer[log_index++] = '\n';
-        log_buffer[log_index] = '\0';
+// Relógio monotônico do host em microssegundos (prazos das fatias das threads)
+long get_monotonic_time_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000L + ts.tv_nsec / 1000;
+}
+
+// Instante do relógio monotônico correspondente a time_ms do relógio do kernel
+long monotonic_deadline_us(long time_ms) {
+    return get_monotonic_time_us() + (time_ms - get_current_time_ms()) * 1000;
+}
+
+static void push_record(const LogRecord* record) {
+    size_t position = __atomic_load_n(&log_ring->tail, __ATOMIC_RELAXED);
+    LogSlot* slot;
+    
+    while (true) {
+        slot = &log_ring->slots[position & LOG_RING_MASK];
+        size_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        long diff = (long)(sequence - position);
+        
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&log_ring->tail, &position, position + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Fila cheia: aguardar a escritora em vez de descartar o registro
+            sched_yield();
+            position = __atomic_load_n(&log_ring->tail, __ATOMIC_RELAXED);
+        } else {
+            position = __atomic_load_n(&log_ring->tail, __ATOMIC_RELAXED);
+        }
+    }
+    
+    slot->record = *record;
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+    
+    // Acordar a escritora apenas se ela estiver dormindo e a fila passou do limiar;
+    // abaixo dele a escritora acorda sozinha a cada LOG_FLUSH_INTERVAL_MS
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&writer_sleeping, __ATOMIC_RELAXED) &&
+        position + 1 - __atomic_load_n(&log_ring->head, __ATOMIC_RELAXED) >= LOG_WAKE_THRESHOLD) {
+        pthread_mutex_lock(&writer_mutex);
+        pthread_cond_signal(&writer_cv);
+        pthread_mutex_unlock(&writer_mutex);
+    }
+}
+
+static bool record_available() {
+    LogSlot* slot = &log_ring->slots[log_ring->head & LOG_RING_MASK];
+    return __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) == log_ring->head + 1;
+}
+
+static bool pop_record(LogRecord* record) {
+    if (!record_available()) return false;
+    
+    LogSlot* slot = &log_ring->slots[log_ring->head & LOG_RING_MASK];
+    *record = slot->record;
+    __atomic_store_n(&slot->sequence, log_ring->head + LOG_RING_SIZE, __ATOMIC_RELEASE);
+    __atomic_store_n(&log_ring->head, log_ring->head + 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+void format_log_record(const LogRecord* record, char* buffer, size_t size) {
+    const char* policy = scheduler_policy_name(record->policy);
+    int len = 0;
+    
+    switch (record->type) {
+        case LOG_DISPATCH:
+            len = snprintf(buffer, size, "[%s] Executando processo PID %d", policy, record->pid);
+            if (record->flags & LOG_SHOW_QUANTUM) {
+                len += snprintf(buffer + len, size - len, " com quantum %dms", record->detail);
+            } else if (record->flags & LOG_SHOW_PRIORITY) {
+                len += snprintf(buffer + len, size - len, " prioridade %d", record->detail);
+            }
+            if (record->cpu != LOG_NO_CPU) {
+                snprintf(buffer + len, size - len, " // processador %d", record->cpu);
+            }
+            break;
+        case LOG_FINISHED:
+            snprintf(buffer, size, "[%s] Processo PID %d finalizado", policy, record->pid);
+            break;
+        case LOG_SCHEDULER_DONE:
+            snprintf(buffer, size, "Escalonador terminou execução de todos processos");
+            break;
+        case LOG_DEADLINE_MISS:
+            snprintf(buffer, size, "[%s] Processo PID %d perdeu o prazo por %dms", policy, record->pid, record->detail);
+            break;
+        default:
+            snprintf(buffer, size, "Registro de log desconhecido (%d)", record->type);
+            break;
+    }
+}
+
+static void write_record(const LogRecord* record) {
+    if (log_binary) {
+        fwrite(record, sizeof(LogRecord), 1, log_file);
+        return;
+    }
+    
+    char line[256];
+    format_log_record(record, line, sizeof(line));
+    fputs(line, log_file);
+    fputc('\n', log_file);
+}
+
+static void* log_writer_thread_function(void* arg) {
+    (void)arg; // Suprimir warning
+    LogRecord record;
+    
+    while (true) {
+        if (pop_record(&record)) {
+            write_record(&record);
+            continue;
+        }
+        
+        // Fila vazia: descarregar o que já foi formatado e dormir até a fila
+        // encher, o próximo período de descarga ou o encerramento
+        fflush(log_file);
+        
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += LOG_FLUSH_INTERVAL_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        
+        pthread_mutex_lock(&writer_mutex);
+        __atomic_store_n(&writer_sleeping, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        bool stop = writer_stop && !record_available();
+        if (!stop) {
+            pthread_cond_timedwait(&writer_cv, &writer_mutex, &deadline);
+        }
+        __atomic_store_n(&writer_sleeping, 0, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&writer_mutex);
+        
+        if (stop) break;
     }
-    pthread_mutex_unlock(&log_mutex);
+    
+    return NULL;
 }
 
-void save_log_to_file() {
-    FILE* file = fopen("log_execucao_minikernel.txt", "w");
-    if (file) {
-        fwrite(log_buffer, 1, log_index, file);
+bool start_logger(bool binary) {
+    void* memory = NULL;
+    if (posix_memalign(&memory, CACHE_LINE_SIZE, sizeof(LogRing)) != 0) return false;
+    log_ring = memory;
+    
+    for (size_t i = 0; i < LOG_RING_SIZE; i++) {
+        log_ring->slots[i].sequence = i;
+    }
+    log_ring->tail = 0;
+    log_ring->head = 0;
+    
+    log_binary = binary;
+    log_file = fopen(binary ? LOG_BINARY_FILE : LOG_TEXT_FILE, binary ? "wb" : "w");
+    if (!log_file) {
+        free(log_ring);
+        log_ring = NULL;
+        return false;
+    }
+    setvbuf(log_file, NULL, _IOFBF, LOG_STREAM_BUFFER);
+    if (binary) {
+        fwrite(LOG_BINARY_MAGIC, sizeof(LOG_BINARY_MAGIC), 1, log_file);
+    }
+    
+    writer_stop = false;
+    pthread_create(&writer_thread, NULL, log_writer_thread_function, NULL);
+    return true;
+}
+
+// Esvazia a fila, encerra a thread escritora e fecha o arquivo
+void stop_logger() {
+    if (!log_ring) return;
+    
+    pthread_mutex_lock(&writer_mutex);
+    writer_stop = true;
+    pthread_cond_signal(&writer_cv);
+    pthread_mutex_unlock(&writer_mutex);
+    pthread_join(writer_thread, NULL);
+    
+    fclose(log_file);
+    free(log_ring);
+    log_file = NULL;
+    log_ring = NULL;
+}
+
+void log_event(LogRecordType type, int policy, int pid, int cpu, int flags, int detail) {
+    if (!log_ring) return;
+    
+    LogRecord record;
+    record.time_ms = get_current_time_ms();
+    record.pid = pid;
+    record.cpu = cpu;
+    record.detail = detail;
+    record.type = (uint8_t)type;
+    record.policy = (uint8_t)policy;
+    record.flags = (uint8_t)flags;
+    record.reserved = 0;
+    push_record(&record);
+}
+
+// Converte um log binário (--binary-log) para o formato texto
+bool decode_log_file(const char* filename, FILE* out) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) return false;
+    
+    char magic[sizeof(LOG_BINARY_MAGIC)];
+    if (fread(magic, sizeof(magic), 1, file) != 1 || memcmp(magic, LOG_BINARY_MAGIC, sizeof(magic)) != 0) {
         fclose(file);
+        return false;
+    }
+    
+    LogRecord record;
+    char line[256];
+    while (fread(&record, sizeof(LogRecord), 1, file) == 1) {
+        format_log_record(&record, line, sizeof(line));
+        fprintf(out, "%s\n", line);
     }
+    
+    fclose(file);
+    return true;
 }
@@ -1,39 +1,250 @@
 #include "scheduler.h"
 #include "process_manager.h"
+#include "simulator.h"
 #include "logger.h"
+#include "worker_pool.h"
+#include "metrics.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <getopt.h>
 #include <pthread.h>
 #include <sys/time.h>
 
+static void print_usage(const char* program) {
+    printf("Uso: %s [--cpus N] [--virtual] [--binary-log] [--metrics ARQ] [--quantum MS] [--slice MS]\n"
+           "          [--adaptive-quantum] [--affinity N] [--migration-cost MS] [--pin-cpus LISTA]\n"
+           "          [--bind-threads] [--gang] <arquivo_entrada>\n", program);
+    printf("     %s --decode-log <arquivo.bin>\n", program);
+    printf("  --cpus N        número de CPUs simuladas (padrão: 1)\n");
+    printf("  --virtual       simula em tempo virtual (eventos discretos, sem esperas reais)\n");
+    printf("  --binary-log    grava registros binários em %s\n", LOG_BINARY_FILE);
+    printf("  --decode-log    converte um log binário para texto na saída padrão\n");
+    printf("  --metrics ARQ   grava métricas por processo e agregadas (CSV, ou JSON se ARQ termina em .json)\n");
+    printf("  --quantum MS    quantum do Round Robin (padrão: %d)\n", QUANTUM_MS);
+    printf("  --slice MS      fatia de execução das threads simuladas (padrão: %d)\n", THREAD_SLICE_MS);
+    printf("  --adaptive-quantum\n");
+    printf("                  RR ajusta o quantum pelo serviço observado e pelo tamanho da fila\n");
+    printf("  --affinity N    processos voltam à última CPU enquanto a fila dela tiver no máximo\n");
+    printf("                  N processos a mais que a da CPU escolhida (padrão: desligado)\n");
+    printf("  --migration-cost MS\n");
+    printf("                  aquecimento por thread somado ao trabalho a cada migração (padrão: 0)\n");
+    printf("  --pin-cpus LISTA\n");
+    printf("                  um executor por CPU simulada, fixado nos núcleos do host da lista\n");
+    printf("                  (ex.: 0-3,6; em rodízio se há mais CPUs que núcleos)\n");
+    printf("  --bind-threads  cada thread só avança numa CPU ocupada pelo processo\n");
+    printf("  --gang          gang scheduling: uma CPU por thread de uma vez, com backfilling\n");
+    printf("                  (implica --bind-threads)\n");
+}
+
+// Lista de núcleos do host no formato "0-3,6"; retorna quantos, ou -1 se inválida
+static int parse_core_list(const char* list, int* cores, int max_cores) {
+    int count = 0;
+    const char* p = list;
+    
+    while (*p) {
+        char* end;
+        long first = strtol(p, &end, 10);
+        long last = first;
+        if (end == p || first < 0) return -1;
+        if (*end == '-') {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+            if (end == p || last < first) return -1;
+        }
+        for (long core = first; core <= last; core++) {
+            if (count == max_cores) return -1;
+            cores[count++] = (int)core;
+        }
+        
+        if (*end != ',' && *end != '\0') return -1;
+        p = *end == ',' ? end + 1 : end;
+    }
+    return count > 0 ? count : -1;
+}
+
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        printf("Uso: %s <arquivo_entrada>\n", argv[0]);
-        return 1;
+    bool virtual_time = false;
+    bool binary_log = false;
+    const char* decode_file = NULL;
+    const char* metrics_file = NULL;
+    int num_cpus = 1;
+    long quantum_ms = QUANTUM_MS;
+    long slice_ms = THREAD_SLICE_MS;
+    bool adaptive_quantum = false;
+    int affinity_tolerance = NO_AFFINITY;
+    long migration_cost_ms = 0;
+    static int host_cores[MAX_HOST_CORES];
+    int num_host_cores = 0;
+    const char* pin_list = NULL;
+    bool bind_threads = false;
+    bool gang_scheduling = false;
+    
+    static struct option long_options[] = {
+        {"cpus", required_argument, NULL, 'c'},
+        {"virtual", no_argument, NULL, 'v'},
+        {"binary-log", no_argument, NULL, 'b'},
+        {"decode-log", required_argument, NULL, 'd'},
+        {"metrics", required_argument, NULL, 'm'},
+        {"quantum", required_argument, NULL, 'q'},
+        {"slice", required_argument, NULL, 's'},
+        {"adaptive-quantum", no_argument, NULL, 'a'},
+        {"affinity", required_argument, NULL, 'A'},
+        {"migration-cost", required_argument, NULL, 'M'},
+        {"pin-cpus", required_argument, NULL, 'P'},
+        {"bind-threads", no_argument, NULL, 'B'},
+        {"gang", no_argument, NULL, 'G'},
+        {NULL, 0, NULL, 0}
+    };
+    
+    int opt;
+    while ((opt = getopt_long(argc, argv, "c:vbd:m:q:s:aA:M:P:BG", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'c':
+                num_cpus = atoi(optarg);
+                if (num_cpus < 1) {
+                    printf("Número de CPUs inválido: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'v':
+                virtual_time = true;
+                break;
+            case 'b':
+                binary_log = true;
+                break;
+            case 'd':
+                decode_file = optarg;
+                break;
+            case 'm':
+                metrics_file = optarg;
+                break;
+            case 'q':
+                quantum_ms = atol(optarg);
+                if (quantum_ms < 1) {
+                    printf("Quantum inválido: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 's':
+                slice_ms = atol(optarg);
+                if (slice_ms < 1) {
+                    printf("Fatia inválida: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'a':
+                adaptive_quantum = true;
+                break;
+            case 'A':
+                affinity_tolerance = atoi(optarg);
+                if (affinity_tolerance < 0) {
+                    printf("Tolerância de afinidade inválida: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'M':
+                migration_cost_ms = atol(optarg);
+                if (migration_cost_ms < 0) {
+                    printf("Custo de migração inválido: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'P':
+                pin_list = optarg;
+                num_host_cores = parse_core_list(optarg, host_cores, MAX_HOST_CORES);
+                if (num_host_cores < 0) {
+                    printf("Lista de núcleos inválida: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'B':
+                bind_threads = true;
+                break;
+            case 'G':
+                // Sem threads presas às CPUs, o tamanho do gang não mudaria nada
+                gang_scheduling = true;
+                bind_threads = true;
+                break;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
     }
     
-    // Determinar número de CPUs
-    int num_cpus = 1;
-    #ifdef MULTIPROCESSADOR
-    num_cpus = 2;
-    #endif
+    if (decode_file != NULL) {
+        if (!decode_log_file(decode_file, stdout)) {
+            printf("Log binário inválido: %s\n", decode_file);
+            return 1;
+        }
+        return 0;
+    }
+    
+    if (optind != argc - 1) {
+        print_usage(argv[0]);
+        return 1;
+    }
     
     // Inicializar
-    gettimeofday(&start_time_global, NULL);
+    if (virtual_time) {
+        enable_virtual_clock();
+    }
     initialize_scheduler(num_cpus);
-    read_input(argv[1]);
-    
-    // Criar threads
-    pthread_t generator_thread, scheduler_thread;
+    scheduler->quantum_ms = quantum_ms;
+    scheduler->slice_ms = slice_ms;
+    scheduler->adaptive_quantum = adaptive_quantum;
+    scheduler->affinity_tolerance = affinity_tolerance;
+    scheduler->migration_cost_ms = migration_cost_ms;
+    scheduler->bind_threads = bind_threads;
+    scheduler->gang_scheduling = gang_scheduling;
+    read_input(argv[optind]);
+    if (scheduler->scheduler_type == EDF) {
+        EDFAdmission admission;
+        edf_admission_test(&admission);
+        if (!admission.admitted) {
+            printf("Teste de admissão EDF: densidade %.2f excede o limite garantido %.2f com %d CPU(s); "
+                   "prazos podem ser perdidos\n", admission.peak_density, admission.bound, num_cpus);
+        }
+    }
     
-    pthread_create(&generator_thread, NULL, process_generator_thread_function, NULL);
-    pthread_create(&scheduler_thread, NULL, scheduler_thread_function, NULL);
+    // Chegadas contam a partir daqui, não do início da leitura da carga
+    gettimeofday(&start_time_global, NULL);
+    if (!start_logger(binary_log)) {
+        printf("Erro ao criar arquivo de log\n");
+        return 1;
+    }
     
-    // Aguardar threads terminarem
-    pthread_join(generator_thread, NULL);
-    pthread_join(scheduler_thread, NULL);
+    if (virtual_time) {
+        run_virtual_simulation();
+    } else {
+        // Pool fixo de workers, criado uma única vez: executa os temporizadores do
+        // kernel (fatias das threads simuladas, chegadas e prazos do escalonador).
+        // Com --pin-cpus as fatias vão para os executores fixados e um worker basta
+        if (!start_worker_pool(num_host_cores > 0 ? 1 : host_worker_count())) {
+            printf("Erro ao criar pool de workers\n");
+            return 1;
+        }
+        if (num_host_cores > 0 && !start_cpu_executors(num_cpus, host_cores, num_host_cores)) {
+            printf("Erro ao fixar executores nos núcleos do host: %s\n", pin_list);
+            return 1;
+        }
+        
+        // Chegadas por temporizador, sem thread geradora
+        start_process_arrivals();
+        
+        pthread_t scheduler_thread;
+        pthread_create(&scheduler_thread, NULL, scheduler_thread_function, NULL);
+        
+        // Aguardar o escalonador terminar
+        pthread_join(scheduler_thread, NULL);
+        stop_worker_pool();
+    }
     
     // Finalizar
-    save_log_to_file();
+    stop_logger();
+    if (metrics_file != NULL && !write_metrics_report(metrics_file)) {
+        printf("Erro ao gravar métricas em %s\n", metrics_file);
+    }
     cleanup_resources();
     
     return 0;
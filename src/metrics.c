@@ -0,0 +1,435 @@
+#include "metrics.h"
+#include "scheduler.h"
+#include "process_manager.h"
+#include "worker_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Estatísticas agregadas de uma métrica por processo
+typedef struct {
+    const char* name;
+    double mean;
+    long p50;
+    long p90;
+    long p99;
+    long max;
+} MetricSummary;
+
+// Totais da execução
+typedef struct {
+    int completed;
+    long duration_ms;           // Do início até o último término
+    long context_switches;
+    long dispatches;
+    long preemptions;
+    long migrations;
+    long migration_penalty_ms;  // Trabalho somado pelas migrações
+    double throughput;          // Processos finalizados por segundo
+    int deadline_processes;     // Processos finalizados que tinham prazo
+    int deadline_misses;
+    double mean_lateness;       // Término - prazo (negativo = adiantado)
+    long max_lateness;
+    EDFAdmission admission;
+    double* target_share;       // Participação alvo por índice em pcb_list
+    double share_error;         // Média de |obtida - alvo|
+    int summary_count;          // Métricas com percentis (latência de preempção e atraso dos temporizadores só se houver)
+} RunSummary;
+
+// Chegada (+bilhetes) ou término (-bilhetes) de um processo
+typedef struct {
+    long time_ms;
+    long tickets;
+    int index;
+} TicketEvent;
+
+static int compare_long(const void* a, const void* b) {
+    long x = *(const long*)a;
+    long y = *(const long*)b;
+    return (x > y) - (x < y);
+}
+
+// Percentil pelo método do posto mais próximo (valores ordenados)
+static long percentile(const long* sorted, int count, int p) {
+    if (count == 0) return 0;
+    int rank = (p * count + 99) / 100;
+    if (rank < 1) rank = 1;
+    return sorted[rank - 1];
+}
+
+static void summarize(MetricSummary* summary, const char* name, long* values, int count) {
+    summary->name = name;
+    summary->mean = 0;
+    
+    qsort(values, count, sizeof(long), compare_long);
+    for (int i = 0; i < count; i++) {
+        summary->mean += values[i];
+    }
+    if (count > 0) summary->mean /= count;
+    
+    summary->p50 = percentile(values, count, 50);
+    summary->p90 = percentile(values, count, 90);
+    summary->p99 = percentile(values, count, 99);
+    summary->max = count > 0 ? values[count - 1] : 0;
+}
+
+static long turnaround_ms(const PCB* pcb) {
+    return pcb->metrics.completion_ms - pcb->metrics.arrival_ms;
+}
+
+static long response_ms(const PCB* pcb) {
+    return pcb->metrics.first_dispatch_ms - pcb->metrics.arrival_ms;
+}
+
+static int compare_ticket_events(const void* a, const void* b) {
+    const TicketEvent* x = a;
+    const TicketEvent* y = b;
+    if (x->time_ms != y->time_ms) return (x->time_ms > y->time_ms) - (x->time_ms < y->time_ms);
+    // No mesmo instante, términos antes de chegadas
+    return (x->tickets > y->tickets) - (x->tickets < y->tickets);
+}
+
+// Participação alvo: média, durante a vida do processo, de seus bilhetes sobre os
+// bilhetes de todos os processos ativos (chegados e não finalizados), como fração
+// da máquina. Acumula F(t) = integral de 1/bilhetes ativos e usa F(término) - F(chegada)
+static bool compute_target_shares(double* target) {
+    TicketEvent* events = malloc(2 * (num_processes + 1) * sizeof(TicketEvent));
+    if (!events) return false;
+    
+    int count = 0;
+    for (int i = 0; i < num_processes; i++) {
+        PCB* pcb = &pcb_list[i];
+        target[i] = 0;
+        if (pcb->metrics.completion_ms < 0) continue;
+        
+        long tickets = process_tickets(pcb);
+        events[count++] = (TicketEvent){pcb->metrics.arrival_ms, tickets, i};
+        events[count++] = (TicketEvent){pcb->metrics.completion_ms, -tickets, i};
+    }
+    qsort(events, count, sizeof(TicketEvent), compare_ticket_events);
+    
+    long active = 0;
+    long previous = 0;
+    double integral = 0;
+    for (int e = 0; e < count; e++) {
+        if (active > 0) integral += (double)(events[e].time_ms - previous) / active;
+        previous = events[e].time_ms;
+        active += events[e].tickets;
+        
+        // Na chegada guarda -F; no término soma F e normaliza pela vida do processo
+        const PCB* pcb = &pcb_list[events[e].index];
+        if (events[e].tickets > 0) {
+            target[events[e].index] = -integral;
+        } else {
+            long lifetime = turnaround_ms(pcb);
+            double share = target[events[e].index] + integral;
+            target[events[e].index] = lifetime > 0 ? share * process_tickets(pcb) / lifetime : 0;
+        }
+    }
+    
+    free(events);
+    return true;
+}
+
+// CPU recebida como fração da máquina (todas as CPUs) durante a vida do processo
+static double achieved_share(const PCB* pcb) {
+    long lifetime = turnaround_ms(pcb);
+    return lifetime > 0 ? (double)pcb->metrics.cpu_ms / ((double)scheduler->num_cpus * lifetime) : 0;
+}
+
+static double mean_quantum(const QuantumStats* stats) {
+    return stats->dispatches > 0 ? (double)stats->total_ms / stats->dispatches : 0.0;
+}
+
+// Vazão da leitura da entrada em MB/s
+static double input_throughput() {
+    return input_stats.load_us > 0 ? input_stats.bytes / (double)input_stats.load_us : 0.0;
+}
+
+static const char* quantum_mode() {
+    return scheduler->adaptive_quantum && scheduler->scheduler_type == RR ? "adaptive" : "fixed";
+}
+
+static bool proportional_share_policy() {
+    return scheduler->scheduler_type == STRIDE || scheduler->scheduler_type == LOTTERY;
+}
+
+static long lateness_ms(const PCB* pcb) {
+    return pcb->metrics.completion_ms - pcb->deadline_ms;
+}
+
+static double utilization(const CPUState* cpu, long duration_ms) {
+    return duration_ms > 0 ? (double)cpu->busy_ms / duration_ms : 0.0;
+}
+
+static void write_csv(FILE* file, MetricSummary summaries[], const RunSummary* run) {
+    fprintf(file, "pid,priority,threads,arrival_ms,first_dispatch_ms,completion_ms,"
+                  "turnaround_ms,waiting_ms,response_ms,preemptions,migrations,migration_penalty_ms,tickets,target_share,achieved_share,"
+                  "deadline_ms,lateness_ms\n");
+    for (int i = 0; i < num_processes; i++) {
+        const PCB* pcb = &pcb_list[i];
+        if (pcb->metrics.completion_ms < 0) continue;
+        
+        fprintf(file, "%d,%d,%d,%ld,%ld,%ld,%ld,%ld,%ld,%d,%d,%d,%ld,%.4f,%.4f,",
+                pcb->pid, pcb->priority, pcb->num_threads,
+                pcb->metrics.arrival_ms, pcb->metrics.first_dispatch_ms, pcb->metrics.completion_ms,
+                turnaround_ms(pcb), pcb->metrics.total_wait_ms, response_ms(pcb),
+                pcb->metrics.preemptions, pcb->metrics.migrations, pcb->metrics.migration_penalty_ms,
+                process_tickets(pcb), run->target_share[i], achieved_share(pcb));
+        // Colunas de prazo vazias para processos sem prazo
+        if (pcb->deadline_ms >= 0) {
+            fprintf(file, "%ld,%ld\n", pcb->deadline_ms, lateness_ms(pcb));
+        } else {
+            fprintf(file, ",\n");
+        }
+    }
+    
+    fprintf(file, "\nmetric,mean,p50,p90,p99,max\n");
+    for (int m = 0; m < run->summary_count; m++) {
+        fprintf(file, "%s,%.2f,%ld,%ld,%ld,%ld\n", summaries[m].name, summaries[m].mean,
+                summaries[m].p50, summaries[m].p90, summaries[m].p99, summaries[m].max);
+    }
+    
+    fprintf(file, "\ncpu,busy_ms,utilization,context_switches,dispatches\n");
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        const CPUState* state = &scheduler->cpus[cpu];
+        fprintf(file, "%d,%ld,%.4f,%ld,%ld\n", cpu, state->busy_ms,
+                utilization(state, run->duration_ms), state->context_switches, state->dispatches);
+    }
+    
+    fprintf(file, "\nsummary,value\n");
+    fprintf(file, "policy,%s\n", scheduler_policy_name(scheduler->scheduler_type));
+    fprintf(file, "cpus,%d\n", scheduler->num_cpus);
+    fprintf(file, "processes,%d\n", run->completed);
+    fprintf(file, "duration_ms,%ld\n", run->duration_ms);
+    fprintf(file, "throughput_per_s,%.4f\n", run->throughput);
+    fprintf(file, "context_switches,%ld\n", run->context_switches);
+    fprintf(file, "dispatches,%ld\n", run->dispatches);
+    fprintf(file, "preemptions,%ld\n", run->preemptions);
+    if (scheduler->num_cpus > 1 && is_preemptive_policy()) {
+        fprintf(file, "partial_preemptions,%ld\n", scheduler->preemption_stats.partial);
+    }
+    fprintf(file, "migrations,%ld\n", run->migrations);
+    fprintf(file, "migration_penalty_ms,%ld\n", run->migration_penalty_ms);
+    fprintf(file, "migration_cost_ms,%ld\n", scheduler->migration_cost_ms);
+    if (scheduler->affinity_tolerance != NO_AFFINITY) {
+        fprintf(file, "affinity_tolerance,%d\n", scheduler->affinity_tolerance);
+    } else {
+        fprintf(file, "affinity_tolerance,off\n");
+    }
+    fprintf(file, "bind_threads,%s\n", scheduler->bind_threads ? "on" : "off");
+    fprintf(file, "gang_scheduling,%s\n", scheduler->gang_scheduling ? "on" : "off");
+    if (scheduler->gang_scheduling) {
+        fprintf(file, "gang_backfills,%ld\n", scheduler->gang_backfills);
+    }
+    fprintf(file, "slice_ms,%ld\n", scheduler->slice_ms);
+    if (timer_jitter.count > 0) {
+        fprintf(file, "pinned_cpus,%d\n", timer_jitter.pinned_cpus);
+    }
+    fprintf(file, "input_format,%s\n", input_stats.binary ? "binary" : "text");
+    fprintf(file, "input_bytes,%zu\n", input_stats.bytes);
+    fprintf(file, "input_load_ms,%.3f\n", input_stats.load_us / 1000.0);
+    fprintf(file, "input_mb_per_s,%.1f\n", input_throughput());
+    
+    // Quanta concedidos (valor configurado ou adaptativo) e as trocas que causaram
+    const QuantumStats* quantum = &scheduler->quantum_stats;
+    if (quantum->dispatches > 0) {
+        fprintf(file, "quantum_mode,%s\n", quantum_mode());
+        fprintf(file, "quantum_mean_ms,%.2f\n", mean_quantum(quantum));
+        fprintf(file, "quantum_min_ms,%ld\n", quantum->min_ms);
+        fprintf(file, "quantum_max_ms,%ld\n", quantum->max_ms);
+        fprintf(file, "quantum_expirations,%ld\n", quantum->expirations);
+    }
+    if (proportional_share_policy()) {
+        fprintf(file, "share_error_mean,%.4f\n", run->share_error);
+    }
+    if (run->deadline_processes > 0) {
+        fprintf(file, "deadline_processes,%d\n", run->deadline_processes);
+        fprintf(file, "deadline_misses,%d\n", run->deadline_misses);
+        fprintf(file, "lateness_mean_ms,%.2f\n", run->mean_lateness);
+        fprintf(file, "lateness_max_ms,%ld\n", run->max_lateness);
+        fprintf(file, "edf_peak_density,%.4f\n", run->admission.peak_density);
+        fprintf(file, "edf_density_bound,%.4f\n", run->admission.bound);
+        fprintf(file, "edf_admitted,%s\n", run->admission.admitted ? "yes" : "no");
+    }
+}
+
+static void write_json(FILE* file, MetricSummary summaries[], const RunSummary* run) {
+    fprintf(file, "{\n");
+    fprintf(file, "  \"policy\": \"%s\",\n", scheduler_policy_name(scheduler->scheduler_type));
+    fprintf(file, "  \"cpus\": %d,\n", scheduler->num_cpus);
+    fprintf(file, "  \"processes\": %d,\n", run->completed);
+    fprintf(file, "  \"duration_ms\": %ld,\n", run->duration_ms);
+    fprintf(file, "  \"throughput_per_s\": %.4f,\n", run->throughput);
+    fprintf(file, "  \"context_switches\": %ld,\n", run->context_switches);
+    fprintf(file, "  \"dispatches\": %ld,\n", run->dispatches);
+    fprintf(file, "  \"preemptions\": %ld,\n", run->preemptions);
+    if (scheduler->num_cpus > 1 && is_preemptive_policy()) {
+        fprintf(file, "  \"partial_preemptions\": %ld,\n", scheduler->preemption_stats.partial);
+    }
+    fprintf(file, "  \"migrations\": %ld,\n", run->migrations);
+    fprintf(file, "  \"migration_penalty_ms\": %ld,\n", run->migration_penalty_ms);
+    fprintf(file, "  \"migration_cost_ms\": %ld,\n", scheduler->migration_cost_ms);
+    if (scheduler->affinity_tolerance != NO_AFFINITY) {
+        fprintf(file, "  \"affinity_tolerance\": %d,\n", scheduler->affinity_tolerance);
+    } else {
+        fprintf(file, "  \"affinity_tolerance\": null,\n");
+    }
+    fprintf(file, "  \"bind_threads\": %s,\n", scheduler->bind_threads ? "true" : "false");
+    fprintf(file, "  \"gang_scheduling\": %s,\n", scheduler->gang_scheduling ? "true" : "false");
+    if (scheduler->gang_scheduling) {
+        fprintf(file, "  \"gang_backfills\": %ld,\n", scheduler->gang_backfills);
+    }
+    fprintf(file, "  \"slice_ms\": %ld,\n", scheduler->slice_ms);
+    if (timer_jitter.count > 0) {
+        fprintf(file, "  \"pinned_cpus\": %d,\n", timer_jitter.pinned_cpus);
+    }
+    fprintf(file, "  \"input\": {\"format\": \"%s\", \"bytes\": %zu, \"load_ms\": %.3f, \"mb_per_s\": %.1f},\n",
+            input_stats.binary ? "binary" : "text", input_stats.bytes, input_stats.load_us / 1000.0,
+            input_throughput());
+    
+    const QuantumStats* quantum = &scheduler->quantum_stats;
+    if (quantum->dispatches > 0) {
+        fprintf(file, "  \"quantum\": {\"mode\": \"%s\", \"mean_ms\": %.2f, \"min_ms\": %ld, \"max_ms\": %ld, \"expirations\": %ld},\n",
+                quantum_mode(), mean_quantum(quantum),
+                quantum->min_ms, quantum->max_ms, quantum->expirations);
+    }
+    if (proportional_share_policy()) {
+        fprintf(file, "  \"share_error_mean\": %.4f,\n", run->share_error);
+    }
+    if (run->deadline_processes > 0) {
+        fprintf(file, "  \"deadline_processes\": %d,\n", run->deadline_processes);
+        fprintf(file, "  \"deadline_misses\": %d,\n", run->deadline_misses);
+        fprintf(file, "  \"lateness_mean_ms\": %.2f,\n", run->mean_lateness);
+        fprintf(file, "  \"lateness_max_ms\": %ld,\n", run->max_lateness);
+        fprintf(file, "  \"edf_admission\": {\"peak_density\": %.4f, \"density_bound\": %.4f, \"admitted\": %s},\n",
+                run->admission.peak_density, run->admission.bound, run->admission.admitted ? "true" : "false");
+    }
+    
+    fprintf(file, "  \"summary\": {\n");
+    for (int m = 0; m < run->summary_count; m++) {
+        fprintf(file, "    \"%s\": {\"mean\": %.2f, \"p50\": %ld, \"p90\": %ld, \"p99\": %ld, \"max\": %ld}%s\n",
+                summaries[m].name, summaries[m].mean, summaries[m].p50, summaries[m].p90,
+                summaries[m].p99, summaries[m].max, m < run->summary_count - 1 ? "," : "");
+    }
+    fprintf(file, "  },\n");
+    
+    fprintf(file, "  \"cpu\": [\n");
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        const CPUState* state = &scheduler->cpus[cpu];
+        fprintf(file, "    {\"cpu\": %d, \"busy_ms\": %ld, \"utilization\": %.4f, \"context_switches\": %ld, \"dispatches\": %ld}%s\n",
+                cpu, state->busy_ms, utilization(state, run->duration_ms), state->context_switches, state->dispatches,
+                cpu < scheduler->num_cpus - 1 ? "," : "");
+    }
+    fprintf(file, "  ],\n");
+    
+    fprintf(file, "  \"processes_detail\": [\n");
+    bool first = true;
+    for (int i = 0; i < num_processes; i++) {
+        const PCB* pcb = &pcb_list[i];
+        if (pcb->metrics.completion_ms < 0) continue;
+        
+        fprintf(file, "%s    {\"pid\": %d, \"priority\": %d, \"threads\": %d, \"arrival_ms\": %ld, "
+                      "\"first_dispatch_ms\": %ld, \"completion_ms\": %ld, \"turnaround_ms\": %ld, "
+                      "\"waiting_ms\": %ld, \"response_ms\": %ld, \"preemptions\": %d, \"migrations\": %d, "
+                      "\"migration_penalty_ms\": %d, "
+                      "\"tickets\": %ld, \"target_share\": %.4f, \"achieved_share\": %.4f",
+                first ? "" : ",\n", pcb->pid, pcb->priority, pcb->num_threads,
+                pcb->metrics.arrival_ms, pcb->metrics.first_dispatch_ms, pcb->metrics.completion_ms,
+                turnaround_ms(pcb), pcb->metrics.total_wait_ms, response_ms(pcb),
+                pcb->metrics.preemptions, pcb->metrics.migrations, pcb->metrics.migration_penalty_ms,
+                process_tickets(pcb), run->target_share[i], achieved_share(pcb));
+        if (pcb->deadline_ms >= 0) {
+            fprintf(file, ", \"deadline_ms\": %ld, \"lateness_ms\": %ld}", pcb->deadline_ms, lateness_ms(pcb));
+        } else {
+            fprintf(file, ", \"deadline_ms\": null, \"lateness_ms\": null}");
+        }
+        first = false;
+    }
+    fprintf(file, "%s  ]\n}\n", first ? "" : "\n");
+}
+
+bool write_metrics_report(const char* filename) {
+    long* turnaround = malloc((num_processes + 1) * sizeof(long));
+    long* waiting = malloc((num_processes + 1) * sizeof(long));
+    long* response = malloc((num_processes + 1) * sizeof(long));
+    double* target_share = malloc((num_processes + 1) * sizeof(double));
+    if (!turnaround || !waiting || !response || !target_share || !compute_target_shares(target_share)) {
+        free(turnaround);
+        free(waiting);
+        free(response);
+        free(target_share);
+        return false;
+    }
+    
+    RunSummary run = {0};
+    run.target_share = target_share;
+    for (int i = 0; i < num_processes; i++) {
+        const PCB* pcb = &pcb_list[i];
+        if (pcb->metrics.completion_ms < 0) continue;
+        
+        turnaround[run.completed] = turnaround_ms(pcb);
+        waiting[run.completed] = pcb->metrics.total_wait_ms;
+        response[run.completed] = response_ms(pcb);
+        run.completed++;
+        
+        if (pcb->metrics.completion_ms > run.duration_ms) run.duration_ms = pcb->metrics.completion_ms;
+        run.preemptions += pcb->metrics.preemptions;
+        run.migrations += pcb->metrics.migrations;
+        run.migration_penalty_ms += pcb->metrics.migration_penalty_ms;
+        run.share_error += fabs(achieved_share(pcb) - target_share[i]);
+        
+        if (pcb->deadline_ms >= 0) {
+            long lateness = lateness_ms(pcb);
+            if (run.deadline_processes == 0 || lateness > run.max_lateness) run.max_lateness = lateness;
+            if (lateness > 0) run.deadline_misses++;
+            run.mean_lateness += lateness;
+            run.deadline_processes++;
+        }
+    }
+    if (run.deadline_processes > 0) {
+        run.mean_lateness /= run.deadline_processes;
+        edf_admission_test(&run.admission);
+    }
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        run.context_switches += scheduler->cpus[cpu].context_switches;
+        run.dispatches += scheduler->cpus[cpu].dispatches;
+    }
+    run.throughput = run.duration_ms > 0 ? run.completed * 1000.0 / run.duration_ms : 0.0;
+    if (run.completed > 0) run.share_error /= run.completed;
+    
+    MetricSummary summaries[5];
+    summarize(&summaries[0], "turnaround_ms", turnaround, run.completed);
+    summarize(&summaries[1], "waiting_ms", waiting, run.completed);
+    summarize(&summaries[2], "response_ms", response, run.completed);
+    run.summary_count = 3;
+    const PreemptionStats* preemption = &scheduler->preemption_stats;
+    if (preemption->count > 0) {
+        summarize(&summaries[run.summary_count++], "preemption_latency_ms", preemption->samples_ms, (int)preemption->count);
+    }
+    if (timer_jitter.count > 0) {
+        summarize(&summaries[run.summary_count++], "timer_jitter_us", timer_jitter.samples_us, (int)timer_jitter.count);
+    }
+    
+    free(turnaround);
+    free(waiting);
+    free(response);
+    
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        free(target_share);
+        return false;
+    }
+    
+    size_t len = strlen(filename);
+    if (len >= 5 && strcmp(filename + len - 5, ".json") == 0) {
+        write_json(file, summaries, &run);
+    } else {
+        write_csv(file, summaries, &run);
+    }
+    
+    fclose(file);
+    free(target_share);
+    return true;
+}
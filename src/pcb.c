@@ -3,14 +3,23 @@
 #include <string.h>
 
 PCB* create_pcb(int pid, int process_len, int priority, int num_threads, int start_time) {
-    PCB* pcb = malloc(sizeof(PCB));
-    if (!pcb) return NULL;
+    // PCB e ponteiros dos TCBs em uma única alocação, alinhada à linha de cache
+    void* memory;
+    if (posix_memalign(&memory, CACHE_LINE_SIZE, sizeof(PCB) + num_threads * sizeof(struct TCB*)) != 0) {
+        return NULL;
+    }
+    PCB* pcb = memory;
     
-    initialize_pcb(pcb, pid, process_len, priority, num_threads, start_time);
+    struct TCB** threads = (struct TCB**)(pcb + 1);
+    for (int i = 0; i < num_threads; i++) {
+        threads[i] = NULL;
+    }
+    initialize_pcb(pcb, pid, process_len, priority, num_threads, start_time, threads);
     return pcb;
 }
 
-void initialize_pcb(PCB* pcb, int pid, int process_len, int priority, int num_threads, int start_time) {
+void initialize_pcb(PCB* pcb, int pid, int process_len, int priority, int num_threads, int start_time,
+                    struct TCB** threads) {
     pcb->pid = pid;
     pcb->process_len = process_len;
     pcb->remaining_time = process_len;
@@ -18,22 +27,42 @@ void initialize_pcb(PCB* pcb, int pid, int process_len, int priority, int num_th
     pcb->num_threads = num_threads;
     pcb->start_time = start_time;
     pcb->state = READY;
+    pcb->cpu_count = 0;
+    pcb->queue_level = priority;
+    pcb->quantum_end_ms = -1;
+    pcb->dispatch_remaining = process_len;
+    pcb->vruntime = 0;
+    pcb->tickets = 0;
+    pcb->relative_deadline = -1;
+    pcb->deadline_ms = -1;
+    
+    pcb->threads = threads;
     
-    pthread_mutex_init(&pcb->mutex, NULL);
-    pthread_cond_init(&pcb->cv, NULL);
-    pcb->thread_ids = malloc(num_threads * sizeof(pthread_t));
+    pcb->metrics.arrival_ms = -1;
+    pcb->metrics.first_dispatch_ms = -1;
+    pcb->metrics.completion_ms = -1;
+    pcb->metrics.ready_since_ms = -1;
+    pcb->metrics.total_wait_ms = 0;
+    pcb->metrics.cpu_ms = 0;
+    pcb->metrics.preemptions = 0;
+    pcb->metrics.migrations = 0;
+    pcb->metrics.migration_penalty_ms = 0;
+    pcb->metrics.last_cpu = -1;
+    
+    pcb->queue = NULL;
+    pcb->queue_prev = NULL;
+    pcb->queue_next = NULL;
+    pcb->level_prev = NULL;
+    pcb->level_next = NULL;
+    pcb->sort_key = process_len;
+    pcb->sort_seq = 0;
+    pcb->heap_index = -1;
 }
 
 void cleanup_pcb(PCB* pcb) {
     if (!pcb) return;
     
-    pthread_mutex_destroy(&pcb->mutex);
-    pthread_cond_destroy(&pcb->cv);
-    
-    if (pcb->thread_ids) {
-        free(pcb->thread_ids);
-        pcb->thread_ids = NULL;
-    }
+    pcb->threads = NULL;
 }
 
 void destroy_pcb(PCB* pcb) {
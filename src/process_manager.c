@@ -2,136 +2,270 @@
 #include "scheduler.h"
 #include "logger.h"
 #include "tcb.h"
+#include "arena.h"
+#include "worker_pool.h"
+#include "trace.h"
 #include <stdio.h>
 #include <stdlib.h>
-#include <unistd.h>
 #include <stdbool.h>
 
+#define PROCESS_ARENA_BLOCK_SIZE (1 << 20)
+
 PCB* pcb_list = NULL;
 int num_processes = 0;
+InputStats input_stats = {0, 0, false};
+
+// PCBs e vetores de IDs de threads ficam contíguos e são liberados de uma vez
+static Arena* process_arena = NULL;
+
+// Chegadas do tempo real: um único temporizador aponta para a próxima
+static ArrivalStream arrivals;
+static Timer arrival_timer;
 
 void read_input(const char* filename) {
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        printf("Erro ao abrir arquivo %s\n", filename);
+    long started_us = get_monotonic_time_us();
+    
+    // Arquivo mapeado e analisado de uma vez (texto) ou lido sem cópia (binário)
+    Trace trace;
+    char error[256];
+    if (!load_trace(filename, &trace, error, sizeof(error))) {
+        printf("Erro ao ler %s: %s\n", filename, error);
+        exit(1);
+    }
+    if (trace.policy < FCFS || trace.policy > LOTTERY) {
+        printf("Erro ao ler %s: política inválida %d\n", filename, trace.policy);
+        exit(1);
+    }
+    
+    num_processes = trace.num_processes;
+    process_arena = create_arena(PROCESS_ARENA_BLOCK_SIZE);
+    pcb_list = arena_alloc_aligned(process_arena, num_processes * sizeof(PCB), CACHE_LINE_SIZE);
+    if (!pcb_list) {
+        printf("Memória insuficiente para %d processos\n", num_processes);
         exit(1);
     }
     
-    fscanf(file, "%d", &num_processes);
-    pcb_list = malloc(num_processes * sizeof(PCB));
+    // Em tempo virtual nenhuma thread é criada
+    bool real_threads = !is_virtual_clock_enabled();
     
     for (int i = 0; i < num_processes; i++) {
         PCB* pcb = &pcb_list[i];
-        int process_len, priority, num_threads, start_time;
+        const TraceRecord* record = &trace.records[i];
         
-        fscanf(file, "%d %d %d %d", 
-               &process_len, &priority, 
-               &num_threads, &start_time);
+        TCB** threads = NULL;
+        if (real_threads) {
+            threads = arena_alloc(process_arena, record->num_threads * sizeof(TCB*));
+        }
         
-        initialize_pcb(pcb, i + 1, process_len, priority, num_threads, start_time);
+        initialize_pcb(pcb, i + 1, record->process_len, record->priority,
+                       record->num_threads, record->start_time, threads);
+        pcb->relative_deadline = record->relative_deadline;
+        pcb->tickets = record->tickets;
     }
+    scheduler->scheduler_type = (SchedulerType)trace.policy;
     
-    int scheduler_type;
-    fscanf(file, "%d", &scheduler_type);
-    scheduler->scheduler_type = (SchedulerType)scheduler_type;
-    
-    fclose(file);
+    input_stats.bytes = trace.bytes;
+    input_stats.binary = trace.binary;
+    input_stats.load_us = get_monotonic_time_us() - started_us;
+    free_trace(&trace);
 }
 
-void* process_thread_function(void* arg) {
-    TCB* tcb = (TCB*)arg;
-    PCB* pcb = tcb->pcb;
+// Desconta uma fatia de um processo em execução, sem trava: o tempo restante só
+// diminui enquanto RUNNING e nunca fica negativo. Verdadeiro apenas para a thread
+// cujo CAS leva o processo a FINISHED, então o término é sinalizado uma única vez
+static bool consume_slice(PCB* pcb, int slice) {
+    if (__atomic_load_n(&pcb->state, __ATOMIC_SEQ_CST) != RUNNING) return false;
     
-    while (true) {
-        pthread_mutex_lock(&pcb->mutex);
-        
-        // Aguardar até o processo estar executando
-        while (pcb->state != RUNNING && pcb->state != FINISHED) {
-            pthread_cond_wait(&pcb->cv, &pcb->mutex);
-        }
-        
-        if (pcb->state == FINISHED) {
-            pthread_mutex_unlock(&pcb->mutex);
+    int remaining = __atomic_load_n(&pcb->remaining_time, __ATOMIC_SEQ_CST);
+    while (remaining > 0) {
+        int next = remaining > slice ? remaining - slice : 0;
+        if (__atomic_compare_exchange_n(&pcb->remaining_time, &remaining, next, false,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+            remaining = next;
             break;
         }
-        
-        pthread_mutex_unlock(&pcb->mutex);
-        
-        // Simular execução por pequenos incrementos
-        usleep(50000); // 50ms
-        
-        pthread_mutex_lock(&pcb->mutex);
-        
-        // Só decrementar se ainda estiver RUNNING
-        if (pcb->state == RUNNING) {
-            pcb->remaining_time -= 50; // Decrementar 50ms
-            
-            if (pcb->remaining_time <= 0) {
-                pcb->remaining_time = 0;
-                pcb->state = FINISHED;
-                pthread_cond_broadcast(&pcb->cv);
-            }
-        }
-        
-        pthread_mutex_unlock(&pcb->mutex);
     }
+    if (remaining > 0) return false;
     
-    destroy_tcb(tcb);
-    return NULL;
+    ProcessState expected = RUNNING;
+    return __atomic_compare_exchange_n(&pcb->state, &expected, FINISHED, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+// Agenda o fim da fatia no executor da CPU do processo (no pool sem --pin-cpus)
+static void schedule_slice(TCB* tcb) {
+    int cpu = __atomic_load_n(&tcb->pcb->metrics.last_cpu, __ATOMIC_RELAXED);
+    add_cpu_timer(cpu, &tcb->slice_timer, tcb->slice_deadline_us);
+}
+
+// Agenda a fatia da thread se ela estava estacionada (só um dos lados vence o CAS)
+static void arm_thread(TCB* tcb, long now_us) {
+    bool parked = false;
+    if (__atomic_compare_exchange_n(&tcb->armed, &parked, true, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+        tcb->slice_deadline_us = now_us + scheduler->slice_ms * 1000L;
+        schedule_slice(tcb);
+    }
 }
 
-void* process_generator_thread_function(void* arg) {
-    (void)arg; // Suprimir warning
+// Executada por um worker do pool ao fim de cada fatia de uma thread simulada
+static void run_thread_slice(Timer* timer) {
+    TCB* tcb = timer->data;
+    PCB* pcb = tcb->pcb;
     
-    // Criar array de índices ordenado por tempo de chegada
-    int* order = malloc(num_processes * sizeof(int));
-    for (int i = 0; i < num_processes; i++) {
-        order[i] = i;
+    // Acordar o escalonador para liberar a CPU sem esperar por polling; com
+    // --bind-threads, a thread sem CPU do processo passa a fatia esperando
+    if (tcb->thread_index < process_running_threads(pcb) && consume_slice(pcb, (int)scheduler->slice_ms)) {
+        notify_scheduler();
     }
     
-    // Ordenar por tempo de chegada
-    for (int i = 0; i < num_processes - 1; i++) {
-        for (int j = i + 1; j < num_processes; j++) {
-            if (pcb_list[order[i]].start_time > pcb_list[order[j]].start_time) {
-                int temp = order[i];
-                order[i] = order[j];
-                order[j] = temp;
-            }
-        }
+    // Em execução, emendar a próxima fatia
+    if (__atomic_load_n(&pcb->state, __ATOMIC_SEQ_CST) == RUNNING) {
+        tcb->slice_deadline_us += scheduler->slice_ms * 1000L;
+        schedule_slice(tcb);
+        return;
     }
     
-    for (int i = 0; i < num_processes; i++) {
-        int index = order[i];
-        PCB* pcb = &pcb_list[index];
+    // Senão a thread estaciona até o próximo despacho. Um despacho entre a leitura
+    // do estado e o estacionamento não vê a thread livre; ela mesma se reativa
+    __atomic_store_n(&tcb->armed, false, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pcb->state, __ATOMIC_SEQ_CST) == RUNNING) {
+        arm_thread(tcb, get_monotonic_time_us());
+    }
+}
+
+// Reativa as threads estacionadas do processo (chamada depois de publicar RUNNING)
+void activate_process_threads(PCB* pcb) {
+    if (!pcb->threads) return;
+    
+    long now = get_monotonic_time_us();
+    for (int j = 0; j < pcb->num_threads; j++) {
+        TCB* tcb = pcb->threads[j];
+        if (tcb != NULL) arm_thread(tcb, now);
+    }
+}
+
+// Uma sequência de pcb_list já ordenada por chegada: [next, end)
+typedef struct ArrivalRun {
+    int next;
+    int end;
+} ArrivalRun;
+
+static bool run_before(const ArrivalRun* a, const ArrivalRun* b) {
+    const PCB* pa = &pcb_list[a->next];
+    const PCB* pb = &pcb_list[b->next];
+    if (pa->start_time != pb->start_time) return pa->start_time < pb->start_time;
+    return a->next < b->next;
+}
+
+static void sift_down_run(ArrivalStream* stream, int i) {
+    while (true) {
+        int left = 2 * i + 1;
+        int right = left + 1;
+        int smallest = i;
         
-        // Aguardar tempo de chegada
-        while (get_current_time_ms() < pcb->start_time) {
-            usleep(10000);
+        if (left < stream->count && run_before(&stream->runs[left], &stream->runs[smallest])) smallest = left;
+        if (right < stream->count && run_before(&stream->runs[right], &stream->runs[smallest])) smallest = right;
+        if (smallest == i) break;
+        
+        ArrivalRun temp = stream->runs[i];
+        stream->runs[i] = stream->runs[smallest];
+        stream->runs[smallest] = temp;
+        i = smallest;
+    }
+}
+
+bool open_arrival_stream(ArrivalStream* stream) {
+    // Cargas geradas já vêm ordenadas: em geral uma única sequência
+    int runs = num_processes > 0 ? 1 : 0;
+    for (int i = 1; i < num_processes; i++) {
+        if (pcb_list[i].start_time < pcb_list[i - 1].start_time) runs++;
+    }
+    
+    stream->runs = malloc((runs + 1) * sizeof(ArrivalRun));
+    stream->count = 0;
+    if (!stream->runs) return false;
+    
+    int begin = 0;
+    for (int i = 1; i <= num_processes; i++) {
+        if (i == num_processes || pcb_list[i].start_time < pcb_list[i - 1].start_time) {
+            stream->runs[stream->count].next = begin;
+            stream->runs[stream->count].end = i;
+            stream->count++;
+            begin = i;
         }
+    }
+    
+    for (int i = stream->count / 2 - 1; i >= 0; i--) {
+        sift_down_run(stream, i);
+    }
+    return true;
+}
+
+PCB* peek_arrival(const ArrivalStream* stream) {
+    return stream->count > 0 ? &pcb_list[stream->runs[0].next] : NULL;
+}
+
+PCB* next_arrival(ArrivalStream* stream) {
+    if (stream->count == 0) return NULL;
+    
+    ArrivalRun* head = &stream->runs[0];
+    PCB* pcb = &pcb_list[head->next++];
+    if (head->next == head->end) {
+        stream->runs[0] = stream->runs[--stream->count];
+    }
+    sift_down_run(stream, 0);
+    return pcb;
+}
+
+void close_arrival_stream(ArrivalStream* stream) {
+    free(stream->runs);
+    stream->runs = NULL;
+    stream->count = 0;
+}
+
+// Libera os processos que já chegaram e reagenda o temporizador para a próxima
+// chegada; executada por um worker do pool, sem thread geradora
+static void release_arrivals(Timer* timer) {
+    long now = get_current_time_ms();
+    while (peek_arrival(&arrivals) != NULL && peek_arrival(&arrivals)->start_time <= now) {
+        PCB* pcb = next_arrival(&arrivals);
         
-        // Criar threads do processo
+        // Criar threads do processo (tarefas do pool, sem pthread_create)
         for (int j = 0; j < pcb->num_threads; j++) {
             TCB* tcb = create_tcb(pcb, j);
-            pthread_create(&pcb->thread_ids[j], NULL, process_thread_function, tcb);
+            init_timer(&tcb->slice_timer, run_thread_slice, tcb);
+            pcb->threads[j] = tcb;
         }
         
         // Adicionar à fila de prontos
-        enqueue_process(scheduler->ready_queue, pcb);
-        
-        // Sinalizar escalonador com alta prioridade para verificação imediata
-        pthread_mutex_lock(&scheduler->scheduler_mutex);
-        pthread_cond_broadcast(&scheduler->scheduler_cv); // broadcast para acordar imediatamente
-        pthread_mutex_unlock(&scheduler->scheduler_mutex);
+        enqueue_ready_process(pcb, ANY_CPU);
+    }
+    
+    PCB* next = peek_arrival(&arrivals);
+    if (next != NULL) {
+        add_timer(timer, monotonic_deadline_us(next->start_time));
+        notify_scheduler();
+        return;
     }
     
-    free(order);
+    close_arrival_stream(&arrivals);
     
     pthread_mutex_lock(&scheduler->scheduler_mutex);
     scheduler->generator_done = true;
-    pthread_cond_signal(&scheduler->scheduler_cv);
+    scheduler->pending_events++;
+    pthread_cond_broadcast(&scheduler->scheduler_cv);
     pthread_mutex_unlock(&scheduler->scheduler_mutex);
+}
+
+void start_process_arrivals() {
+    if (!open_arrival_stream(&arrivals)) {
+        printf("Memória insuficiente para ordenar as chegadas\n");
+        exit(1);
+    }
     
-    return NULL;
+    init_timer(&arrival_timer, release_arrivals, NULL);
+    PCB* first = peek_arrival(&arrivals);
+    add_timer(&arrival_timer, monotonic_deadline_us(first != NULL ? first->start_time : 0));
 }
 
 void cleanup_resources() {
@@ -139,17 +273,17 @@ void cleanup_resources() {
         for (int i = 0; i < num_processes; i++) {
             PCB* pcb = &pcb_list[i];
             
-            // Aguardar threads terminarem
-            for (int t = 0; t < pcb->num_threads; t++) {
-                pthread_join(pcb->thread_ids[t], NULL);
-            }
-            
+            // TCBs são liberados em bloco por destroy_tcb_allocator
             cleanup_pcb(pcb);
         }
-        free(pcb_list);
+        destroy_arena(process_arena);
+        process_arena = NULL;
         pcb_list = NULL;
     }
     
+    destroy_tcb_allocator();
+    free_timer_jitter();
+    
     if (scheduler) {
         destroy_scheduler(scheduler);
         scheduler = NULL;
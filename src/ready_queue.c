@@ -1,12 +1,166 @@
 #include "ready_queue.h"
 #include <stdlib.h>
+#include <stdio.h>
+
+#define INITIAL_HEAP_CAPACITY 64
+
+static int bucket_level(PCB* process) {
+    if (process->queue_level < 0) return 0;
+    if (process->queue_level >= PRIORITY_LEVELS) return PRIORITY_LEVELS - 1;
+    return process->queue_level;
+}
+
+// Ordem do heap: menor chave primeiro, ordem de entrada no empate
+static bool heap_before(const PCB* a, const PCB* b) {
+    if (a->sort_key != b->sort_key) return a->sort_key < b->sort_key;
+    return a->sort_seq < b->sort_seq;
+}
+
+static void heap_place(ReadyQueue* queue, int index, PCB* process) {
+    queue->heap[index] = process;
+    process->heap_index = index;
+}
+
+static void heap_sift_up(ReadyQueue* queue, int index) {
+    PCB* process = queue->heap[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!heap_before(process, queue->heap[parent])) break;
+        heap_place(queue, index, queue->heap[parent]);
+        index = parent;
+    }
+    heap_place(queue, index, process);
+}
+
+static void heap_sift_down(ReadyQueue* queue, int index, int size) {
+    PCB* process = queue->heap[index];
+    while (true) {
+        int child = 2 * index + 1;
+        if (child >= size) break;
+        if (child + 1 < size && heap_before(queue->heap[child + 1], queue->heap[child])) child++;
+        if (!heap_before(queue->heap[child], process)) break;
+        heap_place(queue, index, queue->heap[child]);
+        index = child;
+    }
+    heap_place(queue, index, process);
+}
+
+// Inserir no heap (count ainda não inclui o processo)
+static void heap_insert(ReadyQueue* queue, PCB* process) {
+    if (queue->count == queue->heap_capacity) {
+        int new_capacity = queue->heap_capacity ? queue->heap_capacity * 2 : INITIAL_HEAP_CAPACITY;
+        PCB** grown = realloc(queue->heap, new_capacity * sizeof(PCB*));
+        if (!grown) {
+            printf("Memória insuficiente para enfileirar o PID %d\n", process->pid);
+            exit(1);
+        }
+        queue->heap = grown;
+        queue->heap_capacity = new_capacity;
+    }
+    
+    process->sort_seq = queue->next_seq++;
+    heap_place(queue, queue->count, process);
+    heap_sift_up(queue, queue->count);
+}
+
+// Remover de qualquer posição do heap (count ainda inclui o processo)
+static void heap_remove(ReadyQueue* queue, PCB* process) {
+    int index = process->heap_index;
+    int last = queue->count - 1;
+    process->heap_index = -1;
+    if (index == last) return;
+    
+    PCB* moved = queue->heap[last];
+    heap_place(queue, index, moved);
+    heap_sift_down(queue, index, last);
+    heap_sift_up(queue, moved->heap_index);
+}
+
+// Inserir no fim da lista de chegada e do balde do nível (chamador detém o mutex)
+static void link_process(ReadyQueue* queue, PCB* process) {
+    int level = bucket_level(process);
+    
+    process->queue = queue;
+    process->queue_next = NULL;
+    process->queue_prev = queue->tail;
+    if (queue->tail) {
+        queue->tail->queue_next = process;
+    } else {
+        queue->head = process;
+    }
+    queue->tail = process;
+    
+    process->level_next = NULL;
+    process->level_prev = queue->level_tail[level];
+    if (queue->level_tail[level]) {
+        queue->level_tail[level]->level_next = process;
+    } else {
+        queue->level_head[level] = process;
+        queue->level_mask |= 1ULL << level;
+    }
+    queue->level_tail[level] = process;
+    
+    heap_insert(queue, process);
+    queue->count++;
+}
+
+// Remover de ambas as listas em O(1) (chamador detém o mutex)
+static void unlink_process(ReadyQueue* queue, PCB* process) {
+    int level = bucket_level(process);
+    
+    if (process->queue_prev) {
+        process->queue_prev->queue_next = process->queue_next;
+    } else {
+        queue->head = process->queue_next;
+    }
+    if (process->queue_next) {
+        process->queue_next->queue_prev = process->queue_prev;
+    } else {
+        queue->tail = process->queue_prev;
+    }
+    
+    if (process->level_prev) {
+        process->level_prev->level_next = process->level_next;
+    } else {
+        queue->level_head[level] = process->level_next;
+    }
+    if (process->level_next) {
+        process->level_next->level_prev = process->level_prev;
+    } else {
+        queue->level_tail[level] = process->level_prev;
+    }
+    if (queue->level_head[level] == NULL) {
+        queue->level_mask &= ~(1ULL << level);
+    }
+    
+    heap_remove(queue, process);
+    
+    process->queue = NULL;
+    process->queue_prev = process->queue_next = NULL;
+    process->level_prev = process->level_next = NULL;
+    queue->count--;
+}
+
+// Primeiro processo do balde de maior prioridade (menor valor) não vazio
+static PCB* highest_priority(ReadyQueue* queue) {
+    if (queue->level_mask == 0) return NULL;
+    return queue->level_head[__builtin_ctzll(queue->level_mask)];
+}
 
 ReadyQueue* create_ready_queue() {
     ReadyQueue* queue = malloc(sizeof(ReadyQueue));
     if (!queue) return NULL;
     
-    queue->front = 0;
-    queue->rear = 0;
+    queue->head = NULL;
+    queue->tail = NULL;
+    for (int level = 0; level < PRIORITY_LEVELS; level++) {
+        queue->level_head[level] = NULL;
+        queue->level_tail[level] = NULL;
+    }
+    queue->level_mask = 0;
+    queue->heap = NULL;
+    queue->heap_capacity = 0;
+    queue->next_seq = 0;
     queue->count = 0;
     pthread_mutex_init(&queue->mutex, NULL);
     return queue;
@@ -16,6 +170,7 @@ void destroy_ready_queue(ReadyQueue* queue) {
     if (!queue) return;
     
     pthread_mutex_destroy(&queue->mutex);
+    free(queue->heap);
     free(queue);
 }
 
@@ -23,11 +178,7 @@ void enqueue_process(ReadyQueue* queue, PCB* process) {
     if (!queue || !process) return;
     
     pthread_mutex_lock(&queue->mutex);
-    if (queue->count < MAX_PROCESSES) {
-        queue->processes[queue->rear] = process;
-        queue->rear = (queue->rear + 1) % MAX_PROCESSES;
-        queue->count++;
-    }
+    link_process(queue, process);
     pthread_mutex_unlock(&queue->mutex);
 }
 
@@ -35,16 +186,32 @@ PCB* dequeue_process(ReadyQueue* queue) {
     if (!queue) return NULL;
     
     pthread_mutex_lock(&queue->mutex);
-    PCB* process = NULL;
-    if (queue->count > 0) {
-        process = queue->processes[queue->front];
-        queue->front = (queue->front + 1) % MAX_PROCESSES;
-        queue->count--;
+    PCB* process = queue->head;
+    if (process != NULL) {
+        unlink_process(queue, process);
     }
     pthread_mutex_unlock(&queue->mutex);
     return process;
 }
 
+PCB* dequeue_process_tail(ReadyQueue* queue) {
+    if (!queue) return NULL;
+    
+    pthread_mutex_lock(&queue->mutex);
+    PCB* process = queue->tail;
+    if (process != NULL) {
+        unlink_process(queue, process);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return process;
+}
+
+// Leitura sem lock, usada apenas como estimativa de carga
+int ready_queue_size(ReadyQueue* queue) {
+    if (!queue) return 0;
+    return __atomic_load_n(&queue->count, __ATOMIC_RELAXED);
+}
+
 bool is_queue_empty(ReadyQueue* queue) {
     if (!queue) return true;
     
@@ -58,19 +225,8 @@ void remove_process_from_queue(ReadyQueue* queue, PCB* process) {
     if (!queue || !process) return;
     
     pthread_mutex_lock(&queue->mutex);
-    for (int i = 0; i < queue->count; i++) {
-        int index = (queue->front + i) % MAX_PROCESSES;
-        if (queue->processes[index] == process) {
-            // Remover processo movendo todos os posteriores
-            for (int j = i; j < queue->count - 1; j++) {
-                int curr_index = (queue->front + j) % MAX_PROCESSES;
-                int next_index = (queue->front + j + 1) % MAX_PROCESSES;
-                queue->processes[curr_index] = queue->processes[next_index];
-            }
-            queue->rear = (queue->rear - 1 + MAX_PROCESSES) % MAX_PROCESSES;
-            queue->count--;
-            break;
-        }
+    if (process->queue == queue) {
+        unlink_process(queue, process);
     }
     pthread_mutex_unlock(&queue->mutex);
 }
@@ -79,64 +235,81 @@ PCB* ready_queue_peek_highest_priority(ReadyQueue* queue) {
     if (!queue) return NULL;
     
     pthread_mutex_lock(&queue->mutex);
-    PCB* highest = NULL;
-    
-    for (int i = 0; i < queue->count; i++) {
-        int index = (queue->front + i) % MAX_PROCESSES;
-        PCB* current = queue->processes[index];
-        if (highest == NULL || current->priority < highest->priority) {
-            highest = current;
-        }
-    }
-    
+    PCB* highest = highest_priority(queue);
     pthread_mutex_unlock(&queue->mutex);
     return highest;
 }
 
-PCB* find_highest_priority_process_without_removing(ReadyQueue* queue) {
+PCB* find_highest_priority_process(ReadyQueue* queue) {
     if (!queue) return NULL;
     
     pthread_mutex_lock(&queue->mutex);
-    PCB* highest = NULL;
+    PCB* highest = highest_priority(queue);
+    if (highest != NULL) {
+        unlink_process(queue, highest);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return highest;
+}
+
+// Move todos os processos para o nível 0, mantendo a ordem entre e dentro dos níveis
+// Cada balde é emendado inteiro no fim do nível 0
+void ready_queue_reset_levels(ReadyQueue* queue) {
+    if (!queue) return;
     
-    for (int i = 0; i < queue->count; i++) {
-        int index = (queue->front + i) % MAX_PROCESSES;
-        PCB* current = queue->processes[index];
-        if (highest == NULL || current->priority < highest->priority) {
-            highest = current;
+    pthread_mutex_lock(&queue->mutex);
+    uint64_t mask = queue->level_mask & ~1ULL;
+    while (mask != 0) {
+        int level = __builtin_ctzll(mask);
+        mask &= mask - 1;
+        
+        PCB* first = queue->level_head[level];
+        for (PCB* process = first; process != NULL; process = process->level_next) {
+            process->queue_level = 0;
         }
+        
+        first->level_prev = queue->level_tail[0];
+        if (queue->level_tail[0]) {
+            queue->level_tail[0]->level_next = first;
+        } else {
+            queue->level_head[0] = first;
+        }
+        queue->level_tail[0] = queue->level_tail[level];
+        queue->level_head[level] = NULL;
+        queue->level_tail[level] = NULL;
     }
+    queue->level_mask = queue->level_head[0] ? 1ULL : 0;
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+PCB* ready_queue_peek_min_key(ReadyQueue* queue) {
+    if (!queue) return NULL;
     
+    pthread_mutex_lock(&queue->mutex);
+    PCB* first = queue->count > 0 ? queue->heap[0] : NULL;
     pthread_mutex_unlock(&queue->mutex);
-    return highest;
+    return first;
 }
 
-PCB* find_highest_priority_process(ReadyQueue* queue) {
+PCB* find_min_key_process(ReadyQueue* queue) {
     if (!queue) return NULL;
     
     pthread_mutex_lock(&queue->mutex);
-    PCB* highest = NULL;
-    int highest_index = -1;
-    
-    for (int i = 0; i < queue->count; i++) {
-        int index = (queue->front + i) % MAX_PROCESSES;
-        PCB* current = queue->processes[index];
-        if (highest == NULL || current->priority < highest->priority) {
-            highest = current;
-            highest_index = index;
-        }
+    PCB* first = queue->count > 0 ? queue->heap[0] : NULL;
+    if (first != NULL) {
+        unlink_process(queue, first);
     }
+    pthread_mutex_unlock(&queue->mutex);
+    return first;
+}
+
+// Visita os processos em ordem de entrada, com a fila travada (visit não pode alterá-la)
+void ready_queue_for_each(ReadyQueue* queue, void (*visit)(PCB* process, void* arg), void* arg) {
+    if (!queue) return;
     
-    if (highest != NULL) {
-        // Remover processo da fila
-        for (int i = highest_index; i != queue->rear; i = (i + 1) % MAX_PROCESSES) {
-            int next = (i + 1) % MAX_PROCESSES;
-            queue->processes[i] = queue->processes[next];
-        }
-        queue->rear = (queue->rear - 1 + MAX_PROCESSES) % MAX_PROCESSES;
-        queue->count--;
+    pthread_mutex_lock(&queue->mutex);
+    for (PCB* process = queue->head; process != NULL; process = process->queue_next) {
+        visit(process, arg);
     }
-    
     pthread_mutex_unlock(&queue->mutex);
-    return highest;
 }
@@ -2,27 +2,101 @@
 #include "logger.h"
 #include "process_manager.h"
 #include "ready_queue.h"
+#include "worker_pool.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <stdbool.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
 
 Scheduler* scheduler = NULL;
 
+// Desperta o escalonador no prazo de wait_for_scheduler_event (fim de quantum ou balanceamento)
+static Timer wakeup_timer;
+
+static void wake_scheduler(Timer* timer) {
+    (void)timer; // Suprimir warning
+    notify_scheduler();
+}
+
+// Aloca o estado por CPU e marca todas as CPUs como livres
+static bool create_cpu_state(Scheduler* sched, int num_cpus) {
+    int words = (num_cpus + 63) / 64;
+    
+    void* cpus = NULL;
+    if (posix_memalign(&cpus, CACHE_LINE_SIZE, num_cpus * sizeof(CPUState)) != 0) {
+        cpus = NULL;
+    }
+    sched->cpus = cpus;
+    sched->idle_mask = malloc(words * sizeof(uint64_t));
+    sched->preemption_stats = (PreemptionStats){calloc(num_cpus, sizeof(PCB*)), calloc(num_cpus, sizeof(long)),
+                                                NULL, 0, 0, 0};
+    if (!sched->cpus || !sched->idle_mask || !sched->preemption_stats.pending || !sched->preemption_stats.due_ms) {
+        free(sched->cpus);
+        free(sched->idle_mask);
+        free(sched->preemption_stats.pending);
+        free(sched->preemption_stats.due_ms);
+        return false;
+    }
+    
+    for (int cpu = 0; cpu < num_cpus; cpu++) {
+        sched->cpus[cpu].current_process = NULL;
+        sched->cpus[cpu].busy_ms = 0;
+        sched->cpus[cpu].busy_since_ms = 0;
+        sched->cpus[cpu].context_switches = 0;
+        sched->cpus[cpu].dispatches = 0;
+        sched->cpus[cpu].last_pid = 0;
+        sched->cpus[cpu].run_queue = create_ready_queue();
+        if (!sched->cpus[cpu].run_queue) {
+            while (--cpu >= 0) {
+                destroy_ready_queue(sched->cpus[cpu].run_queue);
+            }
+            free(sched->cpus);
+            free(sched->idle_mask);
+            free(sched->preemption_stats.pending);
+            free(sched->preemption_stats.due_ms);
+            return false;
+        }
+    }
+    for (int w = 0; w < words; w++) {
+        int bits = num_cpus - w * 64;
+        sched->idle_mask[w] = (bits >= 64) ? ~0ULL : ((1ULL << bits) - 1);
+    }
+    sched->idle_count = num_cpus;
+    sched->cpu_changes = 0;
+    sched->ready_count = 0;
+    sched->last_balance_ms = 0;
+    sched->last_boost_ms = 0;
+    sched->cfs_total_weight = 0;
+    sched->min_vruntime = 0;
+    sched->lottery_clock = 0;
+    return true;
+}
+
 Scheduler* create_scheduler(int num_cpus, SchedulerType type) {
     Scheduler* sched = malloc(sizeof(Scheduler));
     if (!sched) return NULL;
     
-    sched->ready_queue = create_ready_queue();
-    if (!sched->ready_queue) {
+    if (!create_cpu_state(sched, num_cpus)) {
         free(sched);
         return NULL;
     }
     
     sched->scheduler_type = type;
     sched->num_cpus = num_cpus;
-    sched->current_process[0] = NULL;
-    sched->current_process[1] = NULL;
+    sched->quantum_ms = QUANTUM_MS;
+    sched->slice_ms = THREAD_SLICE_MS;
+    sched->adaptive_quantum = false;
+    sched->affinity_tolerance = NO_AFFINITY;
+    sched->migration_cost_ms = 0;
+    sched->bind_threads = false;
+    sched->gang_scheduling = false;
+    sched->gang_backfills = 0;
+    sched->burst_estimate_ms = -1;
+    sched->quantum_stats = (QuantumStats){0, 0, -1, -1, 0};
+    sched->pending_events = 0;
     sched->generator_done = false;
     
     pthread_mutex_init(&sched->scheduler_mutex, NULL);
@@ -34,324 +108,1250 @@ Scheduler* create_scheduler(int num_cpus, SchedulerType type) {
 void destroy_scheduler(Scheduler* sched) {
     if (!sched) return;
     
-    destroy_ready_queue(sched->ready_queue);
+    for (int cpu = 0; cpu < sched->num_cpus; cpu++) {
+        destroy_ready_queue(sched->cpus[cpu].run_queue);
+    }
+    free(sched->cpus);
+    free(sched->idle_mask);
+    free(sched->preemption_stats.pending);
+    free(sched->preemption_stats.due_ms);
+    free(sched->preemption_stats.samples_ms);
     pthread_mutex_destroy(&sched->scheduler_mutex);
     pthread_cond_destroy(&sched->scheduler_cv);
     free(sched);
 }
 
 void initialize_scheduler(int num_cpus) {
-    scheduler = malloc(sizeof(Scheduler));
-    scheduler->ready_queue = create_ready_queue();
-    scheduler->num_cpus = num_cpus;
-    scheduler->current_process[0] = NULL;
-    scheduler->current_process[1] = NULL;
-    scheduler->generator_done = false;
-    
-    pthread_mutex_init(&scheduler->scheduler_mutex, NULL);
-    pthread_cond_init(&scheduler->scheduler_cv, NULL);
-}
-
-void handle_monoprocessor_execution(PCB* process, const char* policy_names[], char* log_msg) {
-    if (scheduler->scheduler_type == PRIORITY) {
-        // Implementação específica para Priority com preempção
-        while (true) {
-            pthread_mutex_lock(&process->mutex);
-            if (process->remaining_time <= 0) {
-                process->state = FINISHED;
-                snprintf(log_msg, 256, "[%s] Processo PID %d finalizado", 
-                        policy_names[scheduler->scheduler_type], process->pid);
-                add_to_log(log_msg);
-                scheduler->current_process[0] = NULL;
-                pthread_mutex_unlock(&process->mutex);
-                break;
+    // A política é definida depois, na leitura da entrada
+    scheduler = create_scheduler(num_cpus, FCFS);
+    if (!scheduler) {
+        printf("Erro ao criar escalonador para %d CPUs\n", num_cpus);
+        exit(1);
+    }
+    init_timer(&wakeup_timer, wake_scheduler, NULL);
+}
+
+// Peso do CFS pela prioridade (1 = maior); cada nível vale ~1,5x o seguinte
+static long cfs_weight(PCB* process) {
+    static const long weights[] = {2501, 1586, CFS_NICE_0_WEIGHT, 655, 423};
+    int index = process->priority - 1;
+    if (index < 0) index = 0;
+    if (index > 4) index = 4;
+    return weights[index];
+}
+
+// Bilhetes do stride/loteria: os da diretiva "tickets" ou derivados da prioridade
+long process_tickets(const PCB* process) {
+    if (process->tickets > 0) return process->tickets;
+    int level = process->priority;
+    if (level < 1) level = 1;
+    if (level > 5) level = 5;
+    return (6 - level) * TICKETS_PER_PRIORITY_LEVEL;
+}
+
+// Threads que avançam a cada fatia: todas, ou com --bind-threads uma por CPU ocupada
+// pelo processo (leitura sem lock: os workers a fazem a cada fatia)
+int process_running_threads(const PCB* process) {
+    int threads = process->num_threads > 0 ? process->num_threads : 1;
+    if (!scheduler->bind_threads) return threads;
+    
+    int cpus = __atomic_load_n(&process->cpu_count, __ATOMIC_RELAXED);
+    return cpus < threads ? cpus : threads;
+}
+
+// Stride: passo acumulado pelo serviço recebido, em quanta, inversamente aos bilhetes
+static long stride_charge(PCB* process, long service) {
+    return service * (STRIDE_ONE / process_tickets(process)) / STRIDE_QUANTUM_MS;
+}
+
+// Loteria: chave = relógio do sorteio + Exp(média STRIDE_ONE / bilhetes). O menor
+// entre exponenciais sai com probabilidade proporcional à taxa (aos bilhetes), e
+// pela falta de memória as chaves de quem perdeu seguem valendo para o próximo
+// sorteio, então o heap sorteia em O(log n) sem redistribuir as chaves
+static long lottery_key(PCB* process) {
+    // splitmix64 sobre (pid, entrada na fila): sem estado compartilhado entre threads
+    uint64_t x = ((uint64_t)process->pid << 32) + (uint64_t)process->metrics.preemptions;
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    double unit = ((x >> 11) + 1) * (1.0 / 9007199254740992.0);
+    
+    long clock = __atomic_load_n(&scheduler->lottery_clock, __ATOMIC_RELAXED);
+    return clock + (long)(-log(unit) * STRIDE_ONE / process_tickets(process));
+}
+
+// Migração para uma CPU diferente da última: o cache frio custa migration_cost_ms
+// de aquecimento a cada thread, somados ao trabalho restante
+static void charge_migration(PCB* process) {
+    process->metrics.migrations++;
+    if (scheduler->migration_cost_ms <= 0) return;
+    
+    int threads = process->num_threads > 0 ? process->num_threads : 1;
+    int penalty = (int)(scheduler->migration_cost_ms * threads);
+    __atomic_fetch_add(&process->remaining_time, penalty, __ATOMIC_SEQ_CST);
+    process->metrics.migration_penalty_ms += penalty;
+}
+
+// Sem memória, as amostras seguintes são descartadas
+static void record_preemption_latency(long latency_ms) {
+    PreemptionStats* stats = &scheduler->preemption_stats;
+    if (stats->count == stats->capacity) {
+        long capacity = stats->capacity > 0 ? 2 * stats->capacity : 64;
+        long* grown = realloc(stats->samples_ms, capacity * sizeof(long));
+        if (!grown) return;
+        stats->samples_ms = grown;
+        stats->capacity = capacity;
+    }
+    stats->samples_ms[stats->count++] = latency_ms;
+}
+
+// Atualiza as métricas do processo e da CPU na alocação
+static void account_assignment(CPUState* state, int cpu, PCB* process, long now) {
+    ProcessMetrics* metrics = &process->metrics;
+    
+    if (metrics->ready_since_ms >= 0) {
+        // Despacho a partir da fila de prontos
+        if (metrics->first_dispatch_ms < 0) {
+            metrics->first_dispatch_ms = now;
+        }
+        // A preempção termina quando o processo que a provocou recebe a CPU; se
+        // outro processo a ocupa antes, a marca é descartada
+        PreemptionStats* preemption = &scheduler->preemption_stats;
+        if (preemption->pending[cpu] != NULL) {
+            if (preemption->pending[cpu] == process) record_preemption_latency(now - preemption->due_ms[cpu]);
+            preemption->pending[cpu] = NULL;
+        }
+        metrics->total_wait_ms += now - metrics->ready_since_ms;
+        metrics->ready_since_ms = -1;
+        if (metrics->last_cpu >= 0 && metrics->last_cpu != cpu) charge_migration(process);
+        metrics->last_cpu = cpu;
+        
+        long quantum = process_quantum_ms(process);
+        process->quantum_end_ms = quantum > 0 ? now + quantum : -1;
+        if (quantum > 0) {
+            QuantumStats* stats = &scheduler->quantum_stats;
+            stats->dispatches++;
+            stats->total_ms += quantum;
+            if (stats->min_ms < 0 || quantum < stats->min_ms) stats->min_ms = quantum;
+            if (quantum > stats->max_ms) stats->max_ms = quantum;
+        }
+        process->dispatch_remaining = process->remaining_time;
+        if (scheduler->scheduler_type == LOTTERY) {
+            __atomic_store_n(&scheduler->lottery_clock, process->sort_key, __ATOMIC_RELAXED);
+        }
+        state->dispatches++;
+    } else if (process->cpu_count == 0) {
+        // Realocado sem passar pela fila (compactação do Round Robin)
+        if (metrics->last_cpu != cpu) charge_migration(process);
+        metrics->last_cpu = cpu;
+    }
+    
+    if (state->last_pid != process->pid) {
+        state->context_switches++;
+        state->last_pid = process->pid;
+    }
+    state->busy_since_ms = now;
+}
+
+void assign_process_to_cpu(int cpu, PCB* process) {
+    account_assignment(&scheduler->cpus[cpu], cpu, process, get_current_time_ms());
+    scheduler->cpus[cpu].current_process = process;
+    scheduler->idle_mask[cpu / 64] &= ~(1ULL << (cpu % 64));
+    scheduler->idle_count--;
+    scheduler->cpu_changes++;
+    process->cpu_count++;
+}
+
+void release_cpu(int cpu) {
+    PCB* process = scheduler->cpus[cpu].current_process;
+    if (process == NULL) return;
+    
+    process->cpu_count--;
+    long busy = get_current_time_ms() - scheduler->cpus[cpu].busy_since_ms;
+    scheduler->cpus[cpu].busy_ms += busy;
+    process->metrics.cpu_ms += busy;
+    scheduler->cpus[cpu].current_process = NULL;
+    scheduler->idle_mask[cpu / 64] |= 1ULL << (cpu % 64);
+    scheduler->idle_count++;
+    scheduler->cpu_changes++;
+}
+
+// Menor CPU livre com índice >= from, ou -1 se não houver
+int next_idle_cpu(int from) {
+    if (from >= scheduler->num_cpus) return -1;
+    
+    int words = (scheduler->num_cpus + 63) / 64;
+    int word = from / 64;
+    uint64_t bits = scheduler->idle_mask[word] & (~0ULL << (from % 64));
+    
+    while (bits == 0) {
+        if (++word >= words) return -1;
+        bits = scheduler->idle_mask[word];
+    }
+    return word * 64 + __builtin_ctzll(bits);
+}
+
+// Retira da fila o próximo processo segundo a política
+static PCB* pop_by_policy(ReadyQueue* queue) {
+    switch (scheduler->scheduler_type) {
+        case FCFS:
+            return dequeue_process(queue);
+        case PRIORITY:
+        case MLFQ:
+            return find_highest_priority_process(queue);
+        case RR:
+            return dequeue_process(queue);
+        case SJF:
+        case SRTF:
+        case CFS:
+        case EDF:
+        case STRIDE:
+        case LOTTERY:
+            return find_min_key_process(queue);
+    }
+    return NULL;
+}
+
+// Consulta sem retirar o próximo processo das políticas preemptivas
+static PCB* peek_by_policy(ReadyQueue* queue) {
+    switch (scheduler->scheduler_type) {
+        case PRIORITY:
+        case MLFQ:
+            return ready_queue_peek_highest_priority(queue);
+        case SJF:
+        case SRTF:
+        case CFS:
+        case EDF:
+        case STRIDE:
+        case LOTTERY:
+            return ready_queue_peek_min_key(queue);
+        default:
+            return NULL;
+    }
+}
+
+// Verdadeiro se "a" deve executar antes de "b" segundo a política
+// Leitura sem lock do tempo restante: os processos em execução o decrementam
+static bool policy_before(PCB* a, PCB* b) {
+    switch (scheduler->scheduler_type) {
+        case PRIORITY:
+            return a->priority < b->priority;
+        case SRTF:
+            return __atomic_load_n(&a->remaining_time, __ATOMIC_RELAXED) <
+                   __atomic_load_n(&b->remaining_time, __ATOMIC_RELAXED);
+        case MLFQ:
+            return a->queue_level < b->queue_level;
+        case CFS:
+        case EDF:
+        case STRIDE:
+        case LOTTERY:
+            return a->sort_key < b->sort_key;
+        default:
+            return false;
+    }
+}
+
+// Carga da CPU: fila local + processo em execução
+// Leituras sem lock: é apenas uma heurística de posicionamento
+static int cpu_load(int cpu) {
+    int load = ready_queue_size(scheduler->cpus[cpu].run_queue);
+    if (__atomic_load_n(&scheduler->cpus[cpu].current_process, __ATOMIC_RELAXED) != NULL) {
+        load++;
+    }
+    return load;
+}
+
+// CPU com menor carga, menor índice no empate
+static int least_loaded_cpu() {
+    int best_cpu = 0;
+    int best_load = -1;
+    
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        int load = cpu_load(cpu);
+        if (best_load < 0 || load < best_load) {
+            best_cpu = cpu;
+            best_load = load;
+            if (load == 0) break;
+        }
+    }
+    return best_cpu;
+}
+
+// CFS/stride: menor tempo virtual entre os processos prontos e em execução, sem
+// nunca recuar; chegadas entram com ele para não passarem à frente nem ficarem atrás de todos
+static long current_min_vruntime() {
+    long current = -1;
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        PCB* first = ready_queue_peek_min_key(scheduler->cpus[cpu].run_queue);
+        if (first && (current < 0 || first->sort_key < current)) current = first->sort_key;
+        
+        PCB* running = __atomic_load_n(&scheduler->cpus[cpu].current_process, __ATOMIC_RELAXED);
+        if (running && (current < 0 || running->vruntime < current)) current = running->vruntime;
+    }
+    
+    if (current > scheduler->min_vruntime) scheduler->min_vruntime = current;
+    return scheduler->min_vruntime;
+}
+
+// Afinidade: o processo fica na última CPU enquanto a carga dela não passa a da
+// CPU escolhida em mais de affinity_tolerance processos
+static int affine_cpu(const PCB* process, int cpu) {
+    int last_cpu = process->metrics.last_cpu;
+    if (scheduler->affinity_tolerance == NO_AFFINITY || last_cpu < 0 || last_cpu == cpu) return cpu;
+    return cpu_load(last_cpu) <= cpu_load(cpu) + scheduler->affinity_tolerance ? last_cpu : cpu;
+}
+
+void enqueue_ready_process(PCB* process, int cpu) {
+    if (cpu == ANY_CPU) {
+        cpu = least_loaded_cpu();
+    }
+    cpu = affine_cpu(process, cpu);
+    
+    // Chegada ou retorno à fila após preempção
+    long now = get_current_time_ms();
+    if (process->metrics.arrival_ms < 0) {
+        process->metrics.arrival_ms = now;
+        if (process->relative_deadline > 0) process->deadline_ms = now + process->relative_deadline;
+        if (scheduler->scheduler_type == MLFQ) process->queue_level = 0;
+        if (scheduler->scheduler_type == CFS) {
+            process->vruntime = current_min_vruntime();
+            __atomic_fetch_add(&scheduler->cfs_total_weight, cfs_weight(process), __ATOMIC_RELAXED);
+        }
+        if (scheduler->scheduler_type == STRIDE) process->vruntime = current_min_vruntime();
+    } else if (process->metrics.first_dispatch_ms >= 0) {
+        process->metrics.preemptions++;
+        if (process->quantum_end_ms >= 0 && now >= process->quantum_end_ms) {
+            scheduler->quantum_stats.expirations++;
+        }
+        // CFS/stride: cobrar o serviço recebido no despacho (fatias creditadas por thread)
+        int threads = process->num_threads > 0 ? process->num_threads : 1;
+        long service = (process->dispatch_remaining - process->remaining_time) / threads;
+        if (scheduler->scheduler_type == CFS) {
+            process->vruntime += service * CFS_NICE_0_WEIGHT / cfs_weight(process);
+        } else if (scheduler->scheduler_type == STRIDE) {
+            process->vruntime += stride_charge(process, service);
+        }
+    }
+    process->metrics.ready_since_ms = now;
+    
+    // SJF/SRTF ordenam pelo tempo restante, CFS e stride pelo tempo virtual, a loteria
+    // por uma chave sorteada e o EDF pelo prazo absoluto (sem prazo por último),
+    // todos fixos na fila
+    if (scheduler->scheduler_type == CFS || scheduler->scheduler_type == STRIDE) {
+        process->sort_key = process->vruntime;
+    } else if (scheduler->scheduler_type == LOTTERY) {
+        process->sort_key = lottery_key(process);
+    } else if (scheduler->scheduler_type == EDF) {
+        process->sort_key = process->deadline_ms >= 0 ? process->deadline_ms : LONG_MAX;
+    } else {
+        process->sort_key = process->remaining_time;
+    }
+    
+    // Contar antes de enfileirar: ready_count nunca fica abaixo do real
+    __atomic_fetch_add(&scheduler->ready_count, 1, __ATOMIC_SEQ_CST);
+    enqueue_process(scheduler->cpus[cpu].run_queue, process);
+}
+
+bool has_ready_processes() {
+    return __atomic_load_n(&scheduler->ready_count, __ATOMIC_SEQ_CST) > 0;
+}
+
+// CPU ociosa rouba o melhor processo da fila local mais longa; com afinidade, só
+// de filas com mais de affinity_tolerance processos (os demais esperam pela sua CPU)
+static PCB* steal_process(int thief) {
+    int victim = -1;
+    int victim_size = scheduler->affinity_tolerance == NO_AFFINITY ? 0 : scheduler->affinity_tolerance;
+    
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        if (cpu == thief) continue;
+        int size = ready_queue_size(scheduler->cpus[cpu].run_queue);
+        if (size > victim_size) {
+            victim = cpu;
+            victim_size = size;
+        }
+    }
+    
+    if (victim < 0) return NULL;
+    return pop_by_policy(scheduler->cpus[victim].run_queue);
+}
+
+// MLFQ: a cada MLFQ_BOOST_INTERVAL_MS todos os processos voltam ao nível 0,
+// para que os rebaixados não esperem indefinidamente pelos níveis de cima
+static void boost_process_levels() {
+    long now = get_current_time_ms();
+    if (now - scheduler->last_boost_ms < MLFQ_BOOST_INTERVAL_MS) return;
+    scheduler->last_boost_ms = now;
+    
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        ready_queue_reset_levels(scheduler->cpus[cpu].run_queue);
+        PCB* running = scheduler->cpus[cpu].current_process;
+        if (running != NULL) running->queue_level = 0;
+    }
+}
+
+PCB* select_next_process(int cpu) {
+    if (!has_ready_processes()) return NULL;
+    
+    if (scheduler->scheduler_type == MLFQ) {
+        boost_process_levels();
+    }
+    
+    PCB* process = pop_by_policy(scheduler->cpus[cpu].run_queue);
+    if (process == NULL && scheduler->num_cpus > 1) {
+        process = steal_process(cpu);
+    }
+    
+    if (process != NULL) {
+        __atomic_fetch_sub(&scheduler->ready_count, 1, __ATOMIC_SEQ_CST);
+    }
+    return process;
+}
+
+PCB* peek_next_process(int cpu) {
+    return peek_by_policy(scheduler->cpus[cpu].run_queue);
+}
+
+bool is_preemptive_policy() {
+    return scheduler->scheduler_type == PRIORITY || scheduler->scheduler_type == SRTF ||
+           scheduler->scheduler_type == MLFQ || scheduler->scheduler_type == EDF;
+}
+
+// O processo pronto "candidate" deve tomar a CPU de "running"
+bool should_preempt(PCB* candidate, PCB* running) {
+    return is_preemptive_policy() && policy_before(candidate, running);
+}
+
+// A CPU foi liberada para "candidate", por uma preempção devida desde "due_ms"
+// (ou desde a chegada dele, se posterior); a latência é medida no despacho dele nela
+static void mark_preemption_since(int cpu, PCB* candidate, long due_ms) {
+    long ready_since = candidate->metrics.ready_since_ms;
+    scheduler->preemption_stats.pending[cpu] = candidate;
+    scheduler->preemption_stats.due_ms[cpu] = ready_since > due_ms ? ready_since : due_ms;
+}
+
+// Preempção de uma única vítima: devida desde o seu despacho na CPU liberada
+void mark_preemption(int cpu, PCB* candidate) {
+    mark_preemption_since(cpu, candidate, scheduler->cpus[cpu].busy_since_ms);
+}
+
+// Move processos do fim das filas acima de "ceil_size" para filas abaixo de "limit"
+static void move_excess(int ceil_size, int limit) {
+    int receiver = 0;
+    
+    for (int donor = 0; donor < scheduler->num_cpus; donor++) {
+        ReadyQueue* donor_queue = scheduler->cpus[donor].run_queue;
+        
+        while (ready_queue_size(donor_queue) > ceil_size) {
+            while (receiver < scheduler->num_cpus &&
+                   ready_queue_size(scheduler->cpus[receiver].run_queue) >= limit) {
+                receiver++;
             }
+            if (receiver >= scheduler->num_cpus) return;
             
-            int slice = (process->remaining_time >= 50) ? 50 : process->remaining_time;
-            process->remaining_time -= slice;
-            pthread_mutex_unlock(&process->mutex);
-            usleep(50000); // 50ms
-            
-            // Verificar se existe processo com prioridade mais alta pronto
-            PCB* peek = ready_queue_peek_highest_priority(scheduler->ready_queue);
-            int preempt = 0;
-            if (peek && peek->priority < process->priority) preempt = 1;
-            
-            if (preempt) {
-                pthread_mutex_lock(&process->mutex);
-                if (process->state != FINISHED && process->remaining_time > 0) {
-                    process->state = READY;
-                    scheduler->current_process[0] = NULL;
-                    pthread_mutex_unlock(&process->mutex);
-                    // Colocar processo preemptado de volta na fila
-                    enqueue_process(scheduler->ready_queue, process);
-                } else {
-                    pthread_mutex_unlock(&process->mutex);
-                }
-                break;
-            }
+            PCB* process = dequeue_process_tail(donor_queue);
+            if (process == NULL) break;
+            enqueue_process(scheduler->cpus[receiver].run_queue, process);
+        }
+    }
+}
+
+// Balanceador periódico: executa no máximo uma vez a cada BALANCE_INTERVAL_MS
+void balance_run_queues() {
+    if (scheduler->num_cpus == 1) return;
+    
+    long now = get_current_time_ms();
+    if (now - scheduler->last_balance_ms < BALANCE_INTERVAL_MS) return;
+    scheduler->last_balance_ms = now;
+    
+    int total = 0;
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        total += ready_queue_size(scheduler->cpus[cpu].run_queue);
+    }
+    
+    int floor_size = total / scheduler->num_cpus;
+    int ceil_size = floor_size + (total % scheduler->num_cpus != 0);
+    
+    // Com afinidade, filas até affinity_tolerance acima do teto não doam
+    int donor_size = ceil_size;
+    if (scheduler->affinity_tolerance != NO_AFFINITY) donor_size += scheduler->affinity_tolerance;
+    
+    // Primeiro completar as filas mais vazias até a média, depois até o teto
+    move_excess(donor_size, floor_size);
+    move_excess(donor_size, ceil_size);
+}
+
+// Arredonda para cima em fatias de thread, no mínimo uma: o processo só avança
+// ao fim de cada fatia
+static long round_to_slices(long duration_ms) {
+    long slice = scheduler->slice_ms;
+    duration_ms = (duration_ms + slice - 1) / slice * slice;
+    return duration_ms < slice ? slice : duration_ms;
+}
+
+// RR adaptativo: com o quantum próximo do serviço estimado, a maioria dos processos
+// termina no primeiro despacho sem trocas de contexto extras; com muitos processos
+// esperando, o limite de latência encurta o quantum para manter a resposta
+static long adaptive_quantum_ms() {
+    long estimate = scheduler->burst_estimate_ms >= 0 ? scheduler->burst_estimate_ms : scheduler->quantum_ms;
+    long ready = __atomic_load_n(&scheduler->ready_count, __ATOMIC_RELAXED);
+    long waiting = (ready + scheduler->num_cpus - 1) / scheduler->num_cpus;
+    long latency_cap = ADAPTIVE_TARGET_LATENCY_MS / (waiting + 1);
+    return round_to_slices(estimate < latency_cap ? estimate : latency_cap);
+}
+
+// Quantum do próximo despacho do processo (-1 = executa até o término ou preempção)
+long process_quantum_ms(PCB* process) {
+    switch (scheduler->scheduler_type) {
+        case RR:
+            return scheduler->adaptive_quantum ? adaptive_quantum_ms() : scheduler->quantum_ms;
+        case MLFQ:
+            return (long)MLFQ_BASE_QUANTUM_MS << process->queue_level;
+        case STRIDE:
+        case LOTTERY:
+            return STRIDE_QUANTUM_MS;
+        case CFS: {
+            // Fatia proporcional ao peso entre os executáveis de cada CPU
+            long total = __atomic_load_n(&scheduler->cfs_total_weight, __ATOMIC_RELAXED);
+            long weight = cfs_weight(process);
+            if (total < weight) total = weight;
+            return round_to_slices(CFS_TARGET_LATENCY_MS * weight * scheduler->num_cpus / total);
         }
+        default:
+            return -1;
+    }
+}
+
+// Políticas cujo quantum também vale em multiprocessador (o RR mantém a compactação)
+bool multiprocessor_quantum_enabled() {
+    return scheduler->scheduler_type == MLFQ || scheduler->scheduler_type == CFS ||
+           scheduler->scheduler_type == STRIDE || scheduler->scheduler_type == LOTTERY;
+}
+
+// MLFQ: processo que esgotou o quantum desce um nível
+void demote_process(PCB* process) {
+    if (scheduler->scheduler_type == MLFQ && process->queue_level < MLFQ_LEVELS - 1) {
+        process->queue_level++;
+    }
+}
+
+// Fim do quantum com a tolerância do tempo real (eventos virtuais são exatos)
+static long quantum_deadline(PCB* process) {
+    if (process->quantum_end_ms < 0) return -1;
+    return process->quantum_end_ms + (is_virtual_clock_enabled() ? 0 : QUANTUM_GRACE_MS);
+}
+
+const char* scheduler_policy_name(int type) {
+    static const char* policy_names[] = {"", "FCFS", "RR", "PRIORITY", "SJF", "SRTF", "MLFQ", "CFS", "EDF", "STRIDE", "LOTTERY"};
+    if (type < 0 || type >= (int)(sizeof(policy_names) / sizeof(policy_names[0]))) return "?";
+    return policy_names[type];
+}
+
+// Início (+densidade) ou fim (-densidade) da janela [chegada, prazo] de um processo
+typedef struct {
+    long time_ms;
+    double density;
+} DensityEvent;
+
+static int compare_density_events(const void* a, const void* b) {
+    const DensityEvent* x = a;
+    const DensityEvent* y = b;
+    if (x->time_ms != y->time_ms) return (x->time_ms > y->time_ms) - (x->time_ms < y->time_ms);
+    // No mesmo instante, janelas que terminam saem antes das que começam
+    return (x->density > y->density) - (x->density < y->density);
+}
+
+// Teste suficiente por densidade: cada processo exige custo/prazo de uma CPU, com
+// custo = fatias de 50ms para executar todas as threads juntas. Em cada instante
+// a soma das densidades das janelas abertas não pode passar de m - (m-1)*máxima
+// (limite de Goossens-Funk-Baruah, que em uma CPU reduz a 1)
+void edf_admission_test(EDFAdmission* result) {
+    result->deadline_processes = 0;
+    result->peak_density = 0;
+    result->max_density = 0;
+    
+    DensityEvent* events = malloc(2 * (num_processes + 1) * sizeof(DensityEvent));
+    if (!events) {
+        printf("Memória insuficiente para o teste de admissão\n");
+        exit(1);
+    }
+    
+    int count = 0;
+    for (int i = 0; i < num_processes; i++) {
+        PCB* pcb = &pcb_list[i];
+        if (pcb->relative_deadline <= 0) continue;
+        
+        long per_slice = scheduler->slice_ms * (pcb->num_threads > 0 ? pcb->num_threads : 1);
+        long cost = (pcb->process_len + per_slice - 1) / per_slice * scheduler->slice_ms;
+        double density = (double)cost / pcb->relative_deadline;
+        if (density > result->max_density) result->max_density = density;
+        
+        events[count++] = (DensityEvent){pcb->start_time, density};
+        events[count++] = (DensityEvent){(long)pcb->start_time + pcb->relative_deadline, -density};
+        result->deadline_processes++;
+    }
+    
+    qsort(events, count, sizeof(DensityEvent), compare_density_events);
+    double active = 0;
+    for (int i = 0; i < count; i++) {
+        active += events[i].density;
+        if (active > result->peak_density) result->peak_density = active;
+    }
+    free(events);
+    
+    int m = scheduler->num_cpus;
+    result->bound = m - (m - 1) * result->max_density;
+    result->admitted = result->peak_density <= result->bound + 1e-9;
+}
+
+void log_monoprocessor_dispatch(PCB* process) {
+    long quantum = process_quantum_ms(process);
+    if (quantum > 0) {
+        log_event(LOG_DISPATCH, scheduler->scheduler_type, process->pid, LOG_NO_CPU, LOG_SHOW_QUANTUM, quantum);
+    } else if (scheduler->scheduler_type == PRIORITY) {
+        log_event(LOG_DISPATCH, scheduler->scheduler_type, process->pid, LOG_NO_CPU, LOG_SHOW_PRIORITY, process->priority);
+    } else {
+        log_event(LOG_DISPATCH, scheduler->scheduler_type, process->pid, LOG_NO_CPU, 0, 0);
+    }
+}
+
+// Registra o término no log e nas métricas do processo
+void log_process_finished(PCB* process) {
+    process->metrics.completion_ms = get_current_time_ms();
+    
+    // Serviço do processo (tempo com todas as threads juntas), média exponencial com peso 1/2
+    int threads = process->num_threads > 0 ? process->num_threads : 1;
+    long service = (process->process_len + threads - 1) / threads;
+    long estimate = scheduler->burst_estimate_ms;
+    scheduler->burst_estimate_ms = estimate < 0 ? service : (estimate + service) / 2;
+    
+    if (scheduler->scheduler_type == CFS) {
+        __atomic_fetch_sub(&scheduler->cfs_total_weight, cfs_weight(process), __ATOMIC_RELAXED);
+    }
+    log_event(LOG_FINISHED, scheduler->scheduler_type, process->pid, LOG_NO_CPU, 0, 0);
+    
+    long lateness = process->metrics.completion_ms - process->deadline_ms;
+    if (process->deadline_ms >= 0 && lateness > 0) {
+        log_event(LOG_DEADLINE_MISS, scheduler->scheduler_type, process->pid, LOG_NO_CPU, 0, (int)lateness);
+    }
+}
+
+// Sinaliza ao escalonador uma chegada, um término ou o fim da geração
+void notify_scheduler() {
+    pthread_mutex_lock(&scheduler->scheduler_mutex);
+    scheduler->pending_events++;
+    pthread_cond_broadcast(&scheduler->scheduler_cv);
+    pthread_mutex_unlock(&scheduler->scheduler_mutex);
+}
+
+// Bloqueia até o próximo evento sinalizado ou até deadline_ms (negativo = sem prazo);
+// o prazo é um temporizador na roda do pool, que sinaliza como os demais eventos
+void wait_for_scheduler_event(long deadline_ms) {
+    if (deadline_ms >= 0) {
+        add_timer(&wakeup_timer, monotonic_deadline_us(deadline_ms));
+    }
+    
+    pthread_mutex_lock(&scheduler->scheduler_mutex);
+    while (scheduler->pending_events == 0) {
+        pthread_cond_wait(&scheduler->scheduler_cv, &scheduler->scheduler_mutex);
+    }
+    scheduler->pending_events = 0;
+    pthread_mutex_unlock(&scheduler->scheduler_mutex);
+    
+    if (deadline_ms >= 0) {
+        cancel_timer(&wakeup_timer);
+    }
+}
+
+// O estado de um processo em execução é disputado com os workers das fatias, sem
+// trava: cada transição a partir de RUNNING é um CAS e só um dos lados a realiza
+
+// Verdadeiro se o processo terminou: pelos workers ou, sem tempo restante, aqui
+static bool process_finished(PCB* process) {
+    ProcessState expected = RUNNING;
+    if (__atomic_load_n(&process->remaining_time, __ATOMIC_SEQ_CST) <= 0 &&
+        __atomic_compare_exchange_n(&process->state, &expected, FINISHED, false,
+                                    __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+        return true;
+    }
+    return __atomic_load_n(&process->state, __ATOMIC_SEQ_CST) == FINISHED;
+}
+
+// RUNNING -> READY; falso se o processo terminou antes
+static bool stop_running_process(PCB* process) {
+    ProcessState expected = RUNNING;
+    return __atomic_compare_exchange_n(&process->state, &expected, READY, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static bool is_running(const PCB* process) {
+    return __atomic_load_n(&process->state, __ATOMIC_SEQ_CST) == RUNNING;
+}
+
+// Publica RUNNING antes de reativar as threads estacionadas
+static void start_running_process(PCB* process) {
+    __atomic_store_n(&process->state, RUNNING, __ATOMIC_SEQ_CST);
+}
+
+void handle_monoprocessor_execution(PCB* process) {
+    // FCFS e SJF: aguardar término completo
+    // RR, MLFQ, CFS, stride e loteria: aguardar término ou fim do quantum
+    // PRIORITY, SRTF, MLFQ e EDF: preemptar quando surgir um processo melhor na fila
+    long deadline = quantum_deadline(process);
+    while (true) {
+        if (process_finished(process)) {
+            log_process_finished(process);
+            release_cpu(0);
+            return;
+        }
+        
+        // Verificar se existe processo pronto que deve preemptar o atual
+        PCB* peek = is_preemptive_policy() ? peek_next_process(0) : NULL;
+        if (peek && should_preempt(peek, process) && stop_running_process(process)) {
+            release_cpu(0);
+            mark_preemption(0, peek);
+            // Colocar processo preemptado de volta na fila
+            enqueue_ready_process(process, 0);
+            return;
+        }
+        
+        // O tempo restante é consumido pelas threads do processo;
+        // acordar apenas no término, na chegada de um novo processo ou no fim do quantum
+        if (deadline >= 0 && get_current_time_ms() >= deadline) break;
+        wait_for_scheduler_event(deadline);
+    }
+    
+    // Fim do quantum - parar o processo primeiro
+    if (!stop_running_process(process)) {
+        // Terminou no limite do quantum
+        log_process_finished(process);
+        release_cpu(0);
         return;
     }
+    demote_process(process);
+    release_cpu(0);
+    enqueue_ready_process(process, 0);
+}
+
+static void log_multiprocessor_dispatch(PCB* process, int cpu) {
+    long quantum = process_quantum_ms(process);
+    if (quantum > 0) {
+        log_event(LOG_DISPATCH, scheduler->scheduler_type, process->pid, cpu, LOG_SHOW_QUANTUM, quantum);
+    } else {
+        log_event(LOG_DISPATCH, scheduler->scheduler_type, process->pid, cpu, 0, 0);
+    }
+}
+
+// Libera todas as CPUs do processo e retorna a primeira
+static int release_process_cpus(PCB* process) {
+    int first_cpu = -1;
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        if (scheduler->cpus[cpu].current_process == process) {
+            release_cpu(cpu);
+            if (first_cpu < 0) first_cpu = cpu;
+        }
+    }
+    return first_cpu;
+}
+
+// Melhor processo pronto entre todas as filas locais e a CPU de sua fila
+static PCB* best_ready_process(int* queue_cpu) {
+    PCB* best = NULL;
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        PCB* candidate = peek_next_process(cpu);
+        if (candidate && (best == NULL || policy_before(candidate, best))) {
+            best = candidate;
+            *queue_cpu = cpu;
+        }
+    }
+    return best;
+}
+
+// Traz o melhor processo pronto para a fila da CPU liberada, onde será despachado
+// (a CPU ociosa só rouba de outra fila quando a sua está vazia)
+static void pull_best_ready_process(int freed_cpu) {
+    int best_cpu = -1;
+    PCB* best = best_ready_process(&best_cpu);
+    if (best != NULL && best_cpu != freed_cpu) {
+        remove_process_from_queue(scheduler->cpus[best_cpu].run_queue, best);
+        enqueue_process(scheduler->cpus[freed_cpu].run_queue, best);
+    }
+}
+
+// Despacha na CPU livre o próximo processo da política (falso se não há nenhum)
+static bool dispatch_next_process(int cpu) {
+    // Selecionar processo baseado na política
+    PCB* process = select_next_process(cpu);
+    if (process == NULL) return false;
     
-    // Lógica original para FCFS e RR
-    // Aguardar quantum ou término
-    if (scheduler->scheduler_type == RR) {
-        // Para processos que podem terminar no quantum, aguardar término
-        long start_time = get_current_time_ms();
-        while (get_current_time_ms() - start_time < QUANTUM_MS) {
-            pthread_mutex_lock(&process->mutex);
-            if (process->state == FINISHED) {
-                pthread_mutex_unlock(&process->mutex);
-                break;
-            }
-            pthread_mutex_unlock(&process->mutex);
-            usleep(10000); // 10ms
+    // Afinidade: se a última CPU do processo também está livre, ele volta para ela
+    // (esta CPU é ocupada na repetição do passo)
+    int last_cpu = process->metrics.last_cpu;
+    if (scheduler->affinity_tolerance != NO_AFFINITY && last_cpu >= 0 &&
+        scheduler->cpus[last_cpu].current_process == NULL) {
+        cpu = last_cpu;
+    }
+    
+    start_running_process(process);
+    assign_process_to_cpu(cpu, process);
+    log_multiprocessor_dispatch(process, cpu);
+    
+    activate_process_threads(process);
+    
+    // Se processo tem múltiplas threads, tentar usar próximo CPU livre também
+    // EXCETO para Round Robin, que deve usar apenas um CPU por processo
+    if (process->num_threads > 1 && scheduler->scheduler_type != RR) {
+        int next_cpu = next_idle_cpu(cpu + 1);
+        if (next_cpu >= 0) {
+            assign_process_to_cpu(next_cpu, process);
+            log_multiprocessor_dispatch(process, next_cpu);
+            // Só alocar um CPU adicional por vez
+        }
+    }
+    return true;
+}
+
+// Gang scheduling (--gang): o processo recebe de uma vez uma CPU por thread (até
+// num_cpus) e as devolve juntas. Se o melhor processo pronto não cabe nas CPUs
+// livres, ele espera por elas e processos menores ocupam as que sobram
+// (backfilling), desde que não atrasem o início dele
+
+// CPUs do gang do processo
+static int gang_width(const PCB* process) {
+    int threads = process->num_threads > 0 ? process->num_threads : 1;
+    return threads < scheduler->num_cpus ? threads : scheduler->num_cpus;
+}
+
+// Tempo estimado até o processo liberar as CPUs executando com "width" threads:
+// o tempo restante em fatias, limitado ao quantum
+static long gang_run_ms(PCB* process, int width, long quantum_ms) {
+    long slice = scheduler->slice_ms;
+    long per_slice = slice * (width > 0 ? width : 1);
+    long remaining = __atomic_load_n(&process->remaining_time, __ATOMIC_RELAXED);
+    long run = (remaining + per_slice - 1) / per_slice * slice;
+    return quantum_ms > 0 && quantum_ms < run ? quantum_ms : run;
+}
+
+// Ordem da política entre todas as filas; empates (e FCFS/RR) pela entrada na fila
+static bool gang_before(PCB* a, PCB* b) {
+    if (policy_before(a, b)) return true;
+    if (policy_before(b, a)) return false;
+    if (scheduler->scheduler_type == SJF && a->sort_key != b->sort_key) return a->sort_key < b->sort_key;
+    if (a->metrics.ready_since_ms != b->metrics.ready_since_ms) {
+        return a->metrics.ready_since_ms < b->metrics.ready_since_ms;
+    }
+    return a->pid < b->pid;
+}
+
+// Busca nas filas: o primeiro processo pela política e, para o backfilling, o
+// primeiro que cabe nas CPUs livres sem atrasar a reserva do primeiro
+typedef struct {
+    PCB* head;
+    PCB* backfill;
+    int idle;
+    long now;
+    long shadow_ms;     // Instante estimado em que o primeiro terá suas CPUs
+    int spare;          // CPUs que ainda sobram nesse instante
+} GangScan;
+
+static void visit_head(PCB* process, void* arg) {
+    GangScan* scan = arg;
+    if (scan->head == NULL || gang_before(process, scan->head)) scan->head = process;
+}
+
+static void visit_backfill(PCB* process, void* arg) {
+    GangScan* scan = arg;
+    int width = gang_width(process);
+    if (process == scan->head || width > scan->idle) return;
+    
+    // Termina antes da reserva ou usa só CPUs que o primeiro não vai precisar
+    long run = gang_run_ms(process, width, process_quantum_ms(process));
+    if (scan->now + run > scan->shadow_ms && width > scan->spare) return;
+    if (scan->backfill == NULL || gang_before(process, scan->backfill)) scan->backfill = process;
+}
+
+typedef struct {
+    long release_ms;
+    int cpus;
+} GangRelease;
+
+static int compare_gang_releases(const void* a, const void* b) {
+    const GangRelease* x = a;
+    const GangRelease* y = b;
+    return (x->release_ms > y->release_ms) - (x->release_ms < y->release_ms);
+}
+
+// Reserva do primeiro processo: os gangs em execução liberam todas as CPUs juntos,
+// no fim do quantum ou no término estimado; acumula as liberações em ordem até
+// haver "width" CPUs livres
+static void reserve_gang(GangScan* scan, int width, GangRelease* releases) {
+    int count = 0;
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        PCB* running = scheduler->cpus[cpu].current_process;
+        if (running == NULL) continue;
+        
+        // Cada gang uma vez, pela sua primeira CPU
+        bool seen = false;
+        for (int other = 0; other < cpu && !seen; other++) {
+            seen = scheduler->cpus[other].current_process == running;
         }
+        if (seen) continue;
+        
+        long end = scan->now + gang_run_ms(running, process_running_threads(running), -1);
+        long quantum_end = running->quantum_end_ms;
+        if (quantum_end >= 0 && quantum_end < end) end = quantum_end;
+        releases[count++] = (GangRelease){end, running->cpu_count};
     }
+    qsort(releases, count, sizeof(GangRelease), compare_gang_releases);
     
-    // Verificar se terminou
-    if (scheduler->scheduler_type == RR) {
-        // Para Round Robin, verificar após quantum
-        pthread_mutex_lock(&process->mutex);
-        if (process->state == FINISHED) {
-            snprintf(log_msg, 256, "[%s] Processo PID %d finalizado", 
-                    policy_names[scheduler->scheduler_type], process->pid);
-            add_to_log(log_msg);
-            scheduler->current_process[0] = NULL;
-        } else {
-            // Preempção no Round Robin - parar o processo primeiro
-            process->state = READY;
-            pthread_cond_broadcast(&process->cv); // Acordar threads para verificar estado
-            scheduler->current_process[0] = NULL;
-            pthread_mutex_unlock(&process->mutex);
-            // Só recoloca na fila se ainda tem tempo restante
-            if (process->remaining_time > 0) {
-                enqueue_process(scheduler->ready_queue, process);
-            }
-            return; // Retornar sem unlock
-        }
-        pthread_mutex_unlock(&process->mutex);
-    }
-    
-    // Para FCFS, aguardar término completo
-    if (scheduler->scheduler_type == FCFS) {
-        while (true) {
-            pthread_mutex_lock(&process->mutex);
-            if (process->state == FINISHED) {
-                snprintf(log_msg, 256, "[%s] Processo PID %d finalizado", 
-                        policy_names[scheduler->scheduler_type], process->pid);
-                add_to_log(log_msg);
-                scheduler->current_process[0] = NULL;
-                pthread_mutex_unlock(&process->mutex);
-                break;
-            }
-            pthread_mutex_unlock(&process->mutex);
-            usleep(100000); // 100ms
+    int free_cpus = scan->idle;
+    scan->shadow_ms = scan->now;
+    for (int i = 0; i < count && free_cpus < width; i++) {
+        free_cpus += releases[i].cpus;
+        scan->shadow_ms = releases[i].release_ms;
+    }
+    scan->spare = free_cpus - width;
+}
+
+// Retira o processo da sua fila e o despacha em "width" CPUs livres
+static void start_gang(PCB* process, int width) {
+    remove_process_from_queue(process->queue, process);
+    __atomic_fetch_sub(&scheduler->ready_count, 1, __ATOMIC_SEQ_CST);
+    
+    start_running_process(process);
+    int cpu = next_idle_cpu(0);
+    for (int i = 0; i < width && cpu >= 0; i++) {
+        assign_process_to_cpu(cpu, process);
+        log_multiprocessor_dispatch(process, cpu);
+        cpu = next_idle_cpu(cpu + 1);
+    }
+    activate_process_threads(process);
+}
+
+// Ocupa as CPUs livres com gangs inteiros, na ordem da política com backfilling
+static void dispatch_gangs() {
+    if (scheduler->scheduler_type == MLFQ) boost_process_levels();
+    
+    GangRelease* releases = malloc(scheduler->num_cpus * sizeof(GangRelease));
+    if (!releases) return;
+    
+    while (scheduler->idle_count > 0 && has_ready_processes()) {
+        GangScan scan = {NULL, NULL, scheduler->idle_count, get_current_time_ms(), 0, 0};
+        for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+            ready_queue_for_each(scheduler->cpus[cpu].run_queue, visit_head, &scan);
         }
+        if (scan.head == NULL) break;
+        
+        int width = gang_width(scan.head);
+        if (width <= scan.idle) {
+            start_gang(scan.head, width);
+            continue;
+        }
+        
+        reserve_gang(&scan, width, releases);
+        for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+            ready_queue_for_each(scheduler->cpus[cpu].run_queue, visit_backfill, &scan);
+        }
+        if (scan.backfill == NULL) break;
+        
+        scheduler->gang_backfills++;
+        start_gang(scan.backfill, gang_width(scan.backfill));
     }
+    free(releases);
 }
 
-void handle_multiprocessor_execution(const char* policy_names[], char* log_msg) {
-    // Verificar processos terminados primeiro
+// O processo que esgotou o quantum (descendo de nível no MLFQ) devolve as CPUs
+// se há processos na fila; sem concorrência segue com um novo quantum. A CPU
+// liberada é ocupada na hora, para que quanta que vencem juntos disputem um a um
+// (senão o último a vencer perderia sempre para os que já esperavam)
+static void expire_quanta() {
+    long now = get_current_time_ms();
+    
     for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
-        PCB* process = scheduler->current_process[cpu];
-        if (process != NULL) {
-            pthread_mutex_lock(&process->mutex);
-            if (process->state == FINISHED) {
-                // Verificar se já logamos a finalização deste processo
-                bool already_logged = false;
-                for (int i = 0; i < cpu; i++) {
-                    if (scheduler->current_process[i] == process) {
-                        already_logged = true;
-                        break;
-                    }
-                }
-                
-                if (!already_logged) {
-                    snprintf(log_msg, 256, "[%s] Processo PID %d finalizado", 
-                            policy_names[scheduler->scheduler_type], process->pid);
-                    add_to_log(log_msg);
-                }
-                
-                // Limpar processo de todos os CPUs
-                for (int i = 0; i < scheduler->num_cpus; i++) {
-                    if (scheduler->current_process[i] == process) {
-                        scheduler->current_process[i] = NULL;
-                    }
-                }
-                
-                // Para Round Robin multiprocessador, fazer rebalanceamento após término
-                if (scheduler->scheduler_type == RR && scheduler->num_cpus > 1) {
-                    // Coletar todos os processos ainda em execução
-                    PCB* running_processes[scheduler->num_cpus];
-                    int running_count = 0;
-                    
-                    for (int i = 0; i < scheduler->num_cpus; i++) {
-                        if (scheduler->current_process[i] != NULL && scheduler->current_process[i] != process) {
-                            running_processes[running_count++] = scheduler->current_process[i];
-                            scheduler->current_process[i] = NULL; // Limpar para re-alocar
-                        }
-                    }
-                    
-                    // Re-alocar processos em execução sequencialmente nos CPUs
-                    // Só fazer rebalanceamento se há processos na fila esperando
-                    if (running_count > 0 && !is_queue_empty(scheduler->ready_queue)) {
-                        for (int i = 0; i < running_count; i++) {
-                            scheduler->current_process[i] = running_processes[i];
-                            
-                            snprintf(log_msg, 256, "[%s] Executando processo PID %d com quantum %dms // processador %d", 
-                                    policy_names[scheduler->scheduler_type], running_processes[i]->pid, QUANTUM_MS, i);
-                            add_to_log(log_msg);
-                        }
-                    } else if (running_count > 0) {
-                        // Se não há fila, apenas restaurar processos sem re-logar
-                        for (int i = 0; i < running_count; i++) {
-                            scheduler->current_process[i] = running_processes[i];
-                        }
-                    }
-                }
-                
-                // Sinalizar escalonador para verificar possível expansão
-                pthread_mutex_lock(&scheduler->scheduler_mutex);
-                pthread_cond_signal(&scheduler->scheduler_cv);
-                pthread_mutex_unlock(&scheduler->scheduler_mutex);
-            }
-            pthread_mutex_unlock(&process->mutex);
+        PCB* process = scheduler->cpus[cpu].current_process;
+        if (process == NULL || !is_running(process)) continue;
+        
+        long deadline = quantum_deadline(process);
+        if (deadline < 0 || now < deadline) continue;
+        
+        // Se terminar no meio, o término é tratado no próximo passo
+        demote_process(process);
+        if (!has_ready_processes()) {
+            process->quantum_end_ms = now + process_quantum_ms(process);
+            continue;
+        }
+        if (!stop_running_process(process)) continue;
+        int freed_cpu = release_process_cpus(process);
+        enqueue_ready_process(process, freed_cpu);
+        if (scheduler->gang_scheduling) {
+            dispatch_gangs();
+            continue;
+        }
+        pull_best_ready_process(freed_cpu);
+        dispatch_next_process(freed_cpu);
+    }
+}
+
+// Pior processo em execução segundo a política, fora os "skip_count" de "skip"
+static PCB* worst_running_process(PCB** skip, int skip_count) {
+    PCB* victim = NULL;
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        PCB* running = scheduler->cpus[cpu].current_process;
+        if (!running || !is_running(running) || (victim != NULL && !policy_before(victim, running))) continue;
+        
+        bool skipped = false;
+        for (int i = 0; i < skip_count && !skipped; i++) {
+            skipped = skip[i] == running;
+        }
+        if (!skipped) victim = running;
+    }
+    return victim;
+}
+
+// Gang: preempta os piores processos em execução só se, todos piores que o primeiro
+// de dispatch_gangs, liberam CPUs para o gang inteiro dele; senão ninguém sai (uma
+// preempção que não deixa o gang começar só trocaria a vítima por um backfilling e
+// voltaria a ocorrer)
+static void preempt_for_gang() {
+    GangScan scan = {NULL, NULL, 0, 0, 0, 0};
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        ready_queue_for_each(scheduler->cpus[cpu].run_queue, visit_head, &scan);
+    }
+    PCB* best = scan.head;
+    if (best == NULL) return;
+    
+    PCB** victims = malloc(scheduler->num_cpus * sizeof(PCB*));
+    if (!victims) return;
+    
+    int count = 0;
+    int free_cpus = scheduler->idle_count;
+    while (free_cpus < gang_width(best)) {
+        PCB* victim = worst_running_process(victims, count);
+        if (victim == NULL || !should_preempt(best, victim)) {
+            free(victims);
+            return;
         }
+        victims[count++] = victim;
+        free_cpus += victim->cpu_count;
     }
     
-    // Verificar se há processos em execução que podem se expandir para CPUs livres
+    // Devida desde o despacho da última vítima a começar
+    long due_ms = -1;
+    for (int i = 0; i < count; i++) {
+        if (!stop_running_process(victims[i])) continue;
+        int freed_cpu = release_process_cpus(victims[i]);
+        long since = scheduler->cpus[freed_cpu].busy_since_ms;
+        if (since > due_ms) due_ms = since;
+        enqueue_ready_process(victims[i], freed_cpu);
+    }
+    free(victims);
+    
+    // O gang começa pela primeira CPU livre (ver start_gang)
+    int first_cpu = next_idle_cpu(0);
+    if (due_ms >= 0 && first_cpu >= 0) mark_preemption_since(first_cpu, best, due_ms);
+}
+
+// Última CPU ocupada pelo processo
+static int last_process_cpu(const PCB* process) {
+    for (int cpu = scheduler->num_cpus - 1; cpu >= 0; cpu--) {
+        if (scheduler->cpus[cpu].current_process == process) return cpu;
+    }
+    return -1;
+}
+
+// Com todas as CPUs ocupadas, o melhor processo pronto (entre todas as filas locais)
+// desaloca o pior processo em execução, ou uma CPU dele se está expandido
+static void preempt_running_process() {
+    if (!has_ready_processes()) return;
+    // Em gang scheduling o primeiro da fila pode esperar com CPUs livres
+    if (scheduler->gang_scheduling) {
+        preempt_for_gang();
+        return;
+    }
+    if (scheduler->idle_count > 0) return;
+    
+    int best_cpu = -1;
+    PCB* best = best_ready_process(&best_cpu);
+    if (best == NULL) return;
+    
+    PCB* victim = worst_running_process(NULL, 0);
+    if (victim == NULL || !should_preempt(best, victim)) return;
+    
+    // Processo expandido: perde só uma CPU e segue nas demais; a última sai com
+    // ele, liberando todas as CPUs do processo preemptado
+    int freed_cpu;
+    if (victim->cpu_count > 1) {
+        freed_cpu = last_process_cpu(victim);
+        release_cpu(freed_cpu);
+        scheduler->preemption_stats.partial++;
+    } else {
+        if (!stop_running_process(victim)) return;
+        freed_cpu = release_process_cpus(victim);
+        enqueue_ready_process(victim, freed_cpu);
+    }
+    
+    // A CPU liberada é ocupada na hora, antes que uma expansão a tome
+    mark_preemption(freed_cpu, best);
+    pull_best_ready_process(freed_cpu);
+    dispatch_next_process(freed_cpu);
+}
+
+// Há processo pronto que desalocaria algum em execução: as CPUs livres ficam para ele
+static bool preemption_pending() {
+    if (!is_preemptive_policy() || !has_ready_processes()) return false;
+    
+    int best_cpu = -1;
+    PCB* best = best_ready_process(&best_cpu);
+    PCB* victim = worst_running_process(NULL, 0);
+    return best != NULL && victim != NULL && should_preempt(best, victim);
+}
+
+void handle_multiprocessor_execution() {
+    bool finished_any = false;
+    
+    // Verificar processos terminados primeiro
     for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
-        PCB* running_process = scheduler->current_process[cpu];
-        if (running_process != NULL && running_process->state == RUNNING) {
-            // Verificar se processo pode usar mais CPUs
-            int current_cpus = 0;
-            for (int i = 0; i < scheduler->num_cpus; i++) {
-                if (scheduler->current_process[i] == running_process) {
-                    current_cpus++;
-                }
+        PCB* process = scheduler->cpus[cpu].current_process;
+        if (process != NULL && __atomic_load_n(&process->state, __ATOMIC_SEQ_CST) == FINISHED) {
+            release_cpu(cpu);
+            
+            // Logar a finalização uma única vez, ao liberar a última CPU do processo
+            if (process->cpu_count == 0) {
+                log_process_finished(process);
+                finished_any = true;
             }
+        }
+    }
+    
+    if (finished_any) {
+        // Para Round Robin multiprocessador, fazer rebalanceamento após término:
+        // processos em execução são re-alocados sequencialmente nos CPUs
+        // (com afinidade eles ficam onde estão: a compactação migraria todos)
+        if (scheduler->scheduler_type == RR && scheduler->affinity_tolerance == NO_AFFINITY &&
+            !scheduler->gang_scheduling) {
+            // Só relogar se há processos na fila esperando
+            bool relog = has_ready_processes();
+            int target = 0;
             
-            // Em multiprocessador, processo pode usar quantos CPUs estiverem livres
-            // Para Round Robin, só expandir se não há processos na fila
-            bool can_expand = (scheduler->scheduler_type != RR) || is_queue_empty(scheduler->ready_queue);
-            if (current_cpus < scheduler->num_cpus && can_expand) {
-                bool expanded = false;
+            for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+                PCB* running = scheduler->cpus[cpu].current_process;
+                if (running == NULL) continue;
                 
-                // Alocar CPUs livres (sem logar ainda)
-                for (int free_cpu = 0; free_cpu < scheduler->num_cpus; free_cpu++) {
-                    if (scheduler->current_process[free_cpu] == NULL) {
-                        scheduler->current_process[free_cpu] = running_process;
-                        expanded = true;
-                    }
+                if (cpu != target) {
+                    release_cpu(cpu);
+                    assign_process_to_cpu(target, running);
                 }
-                
-                // Se houve expansão, logar todos os CPUs onde o processo agora está executando
-                if (expanded) {
-                    for (int all_cpu = 0; all_cpu < scheduler->num_cpus; all_cpu++) {
-                        if (scheduler->current_process[all_cpu] == running_process) {
-                            if (scheduler->scheduler_type == RR) {
-                                snprintf(log_msg, 256, "[%s] Executando processo PID %d com quantum %dms // processador %d", 
-                                        policy_names[scheduler->scheduler_type], running_process->pid, QUANTUM_MS, all_cpu);
-                            } else {
-                                snprintf(log_msg, 256, "[%s] Executando processo PID %d // processador %d", 
-                                        policy_names[scheduler->scheduler_type], running_process->pid, all_cpu);
-                            }
-                            add_to_log(log_msg);
-                        }
-                    }
+                if (relog) {
+                    log_multiprocessor_dispatch(running, target);
                 }
+                target++;
             }
         }
+        
+        // As CPUs liberadas permitem expansão: schedule_multiprocessor repete o passo
     }
     
-    // Alocar novos processos para CPUs livres
-    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
-        if (scheduler->current_process[cpu] == NULL) {
-            PCB* process = NULL;
-            
-            // Selecionar processo baseado na política
-            switch (scheduler->scheduler_type) {
-                case FCFS:
-                    process = dequeue_process(scheduler->ready_queue);
-                    break;
-                case PRIORITY:
-                    process = find_highest_priority_process(scheduler->ready_queue);
-                    break;
-                case RR:
-                    process = dequeue_process(scheduler->ready_queue);
-                    break;
+    if (multiprocessor_quantum_enabled()) {
+        expire_quanta();
+    }
+    
+    // Verificar se há processo em execução que pode se expandir para CPUs livres
+    // FCFS e PRIORITY expandem mesmo com processos na fila (PRIORITY só se nenhum deles
+    // preempta um processo em execução); as demais políticas só expandem se não há
+    // processos esperando; gangs já começam com todas as suas CPUs
+    bool can_expand = !scheduler->gang_scheduling &&
+                      (scheduler->scheduler_type == FCFS || scheduler->scheduler_type == PRIORITY ||
+                       !has_ready_processes());
+    if (can_expand && scheduler->idle_count > 0 && scheduler->idle_count < scheduler->num_cpus &&
+        !preemption_pending()) {
+        // O primeiro processo em execução (na ordem das CPUs) ocupa todas as CPUs livres
+        PCB* running_process = NULL;
+        for (int cpu = 0; cpu < scheduler->num_cpus && running_process == NULL; cpu++) {
+            PCB* process = scheduler->cpus[cpu].current_process;
+            if (process != NULL && is_running(process)) {
+                running_process = process;
+            }
+        }
+        
+        if (running_process != NULL) {
+            for (int free_cpu = next_idle_cpu(0); free_cpu >= 0; free_cpu = next_idle_cpu(free_cpu + 1)) {
+                assign_process_to_cpu(free_cpu, running_process);
             }
             
-            if (process != NULL) {
-                pthread_mutex_lock(&process->mutex);
-                process->state = RUNNING;
-                scheduler->current_process[cpu] = process;
-                
-                if (scheduler->scheduler_type == RR) {
-                    snprintf(log_msg, 256, "[%s] Executando processo PID %d com quantum %dms // processador %d", 
-                            policy_names[scheduler->scheduler_type], process->pid, QUANTUM_MS, cpu);
-                } else {
-                    snprintf(log_msg, 256, "[%s] Executando processo PID %d // processador %d", 
-                            policy_names[scheduler->scheduler_type], process->pid, cpu);
-                }
-                add_to_log(log_msg);
-                
-                pthread_cond_broadcast(&process->cv);
-                pthread_mutex_unlock(&process->mutex);
-                
-                // Se processo tem múltiplas threads, tentar usar próximo CPU livre também
-                // EXCETO para Round Robin, que deve usar apenas um CPU por processo
-                if (process->num_threads > 1 && scheduler->scheduler_type != RR) {
-                    for (int next_cpu = cpu + 1; next_cpu < scheduler->num_cpus; next_cpu++) {
-                        if (scheduler->current_process[next_cpu] == NULL) {
-                            scheduler->current_process[next_cpu] = process;
-                            
-                            snprintf(log_msg, 256, "[%s] Executando processo PID %d // processador %d", 
-                                    policy_names[scheduler->scheduler_type], process->pid, next_cpu);
-                            add_to_log(log_msg);
-                            break; // Só alocar um CPU adicional por vez
-                        }
-                    }
+            // Logar todos os CPUs onde o processo agora está executando
+            for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+                if (scheduler->cpus[cpu].current_process == running_process) {
+                    log_multiprocessor_dispatch(running_process, cpu);
                 }
             }
         }
     }
+    
+    // Alocar novos processos para CPUs livres (com afinidade, uma CPU que não
+    // rouba não impede as seguintes de despacharem das próprias filas)
+    if (scheduler->gang_scheduling) {
+        dispatch_gangs();
+    } else {
+        for (int cpu = next_idle_cpu(0); cpu >= 0; cpu = next_idle_cpu(cpu + 1)) {
+            if (!dispatch_next_process(cpu) && !has_ready_processes()) break;
+        }
+    }
+    
+    // PRIORITY: a chegada de um processo de maior prioridade preempta o de menor
+    // SRTF: a de um processo mais curto preempta o de maior tempo restante
+    // MLFQ: a de um processo de nível mais alto preempta o de nível mais baixo
+    // EDF: a de um processo de prazo mais cedo preempta o de prazo mais tarde
+    if (is_preemptive_policy()) {
+        preempt_running_process();
+    }
+}
+
+// Repete o passo multiprocessador até a alocação de CPUs estabilizar
+void schedule_multiprocessor() {
+    long changes;
+    
+    balance_run_queues();
+    do {
+        changes = scheduler->cpu_changes;
+        handle_multiprocessor_execution();
+    } while (changes != scheduler->cpu_changes);
+}
+
+// Fim de quantum mais próximo entre os processos em execução (-1 se nenhum)
+static long next_quantum_deadline() {
+    if (!multiprocessor_quantum_enabled()) return -1;
+    
+    long earliest = -1;
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        PCB* process = scheduler->cpus[cpu].current_process;
+        if (process == NULL) continue;
+        
+        long deadline = quantum_deadline(process);
+        if (deadline >= 0 && (earliest < 0 || deadline < earliest)) {
+            earliest = deadline;
+        }
+    }
+    return earliest;
 }
 
 void* scheduler_thread_function(void* arg) {
     (void)arg; // Suprimir warning
-    char log_msg[256];
-    const char* policy_names[] = {"", "FCFS", "RR", "PRIORITY"};
     
     while (true) {
         pthread_mutex_lock(&scheduler->scheduler_mutex);
         
         // Verificar se ainda há processos em execução
-        bool has_running_processes = false;
-        for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
-            if (scheduler->current_process[cpu] != NULL) {
-                has_running_processes = true;
-                break;
-            }
-        }
+        bool has_running_processes = scheduler->idle_count < scheduler->num_cpus;
         
         // Aguardar se não há processos prontos e não há processos em execução
-        while (is_queue_empty(scheduler->ready_queue) && !scheduler->generator_done && !has_running_processes) {
+        while (!has_ready_processes() && !scheduler->generator_done && !has_running_processes) {
             pthread_cond_wait(&scheduler->scheduler_cv, &scheduler->scheduler_mutex);
             
             // Recalcular após acordar
-            has_running_processes = false;
-            for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
-                if (scheduler->current_process[cpu] != NULL) {
-                    has_running_processes = true;
-                    break;
-                }
-            }
+            has_running_processes = scheduler->idle_count < scheduler->num_cpus;
         }
         
-        if (is_queue_empty(scheduler->ready_queue) && scheduler->generator_done && !has_running_processes) {
+        if (!has_ready_processes() && scheduler->generator_done && !has_running_processes) {
             pthread_mutex_unlock(&scheduler->scheduler_mutex);
             break;
         }
@@ -364,50 +1364,40 @@ void* scheduler_thread_function(void* arg) {
             PCB* process = NULL;
             
             // Selecionar processo baseado na política (apenas se CPU livre)
-            if (scheduler->current_process[0] == NULL) {
-                switch (scheduler->scheduler_type) {
-                    case FCFS:
-                        process = dequeue_process(scheduler->ready_queue);
-                        break;
-                    case PRIORITY:
-                        process = find_highest_priority_process(scheduler->ready_queue);
-                        break;
-                    case RR:
-                        process = dequeue_process(scheduler->ready_queue);
-                        break;
-                }
+            if (scheduler->cpus[0].current_process == NULL) {
+                process = select_next_process(0);
                 
                 if (process != NULL) {
-                    pthread_mutex_lock(&process->mutex);
-                    process->state = RUNNING;
-                    scheduler->current_process[0] = process;
-                    
-                    if (scheduler->scheduler_type == RR) {
-                        snprintf(log_msg, 256, "[%s] Executando processo PID %d com quantum %dms", 
-                                policy_names[scheduler->scheduler_type], process->pid, QUANTUM_MS);
-                    } else if (scheduler->scheduler_type == PRIORITY) {
-                        snprintf(log_msg, 256, "[%s] Executando processo PID %d prioridade %d", 
-                                policy_names[scheduler->scheduler_type], process->pid, process->priority);
-                    } else {
-                        snprintf(log_msg, 256, "[%s] Executando processo PID %d", 
-                                policy_names[scheduler->scheduler_type], process->pid);
-                    }
-                    add_to_log(log_msg);
+                    start_running_process(process);
+                    assign_process_to_cpu(0, process);
+                    log_monoprocessor_dispatch(process);
                     
-                    pthread_cond_broadcast(&process->cv);
-                    pthread_mutex_unlock(&process->mutex);
+                    activate_process_threads(process);
                     
-                    handle_monoprocessor_execution(process, policy_names, log_msg);
+                    handle_monoprocessor_execution(process);
                 }
             }
         } else {
             // Multiprocessador
-            handle_multiprocessor_execution(policy_names, log_msg);
+            schedule_multiprocessor();
+            
+            // Com CPUs ocupadas, dormir até a próxima chegada ou término (e, com
+            // processos na fila, até o próximo balanceamento); sem nenhuma, a espera
+            // no início do laço trata chegadas e o encerramento
+            if (scheduler->idle_count < scheduler->num_cpus) {
+                long deadline = -1;
+                if (has_ready_processes()) {
+                    deadline = scheduler->last_balance_ms + BALANCE_INTERVAL_MS;
+                }
+                long quantum_end = next_quantum_deadline();
+                if (quantum_end >= 0 && (deadline < 0 || quantum_end < deadline)) {
+                    deadline = quantum_end;
+                }
+                wait_for_scheduler_event(deadline);
+            }
         }
-        
-        usleep(50); // 0.05ms de intervalo - muito rápido para máxima responsividade
     }
     
-    add_to_log("Escalonador terminou execução de todos processos");
+    log_event(LOG_SCHEDULER_DONE, scheduler->scheduler_type, 0, LOG_NO_CPU, 0, 0);
     return NULL;
 }
@@ -0,0 +1,203 @@
+#include "simulator.h"
+#include "scheduler.h"
+#include "process_manager.h"
+#include "event_queue.h"
+#include "logger.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+static EventQueue* events = NULL;
+static int* epochs = NULL;  // Geração de despacho de cada processo (índice pid - 1)
+static bool* armed = NULL;  // Processo possui fim de fatia agendado
+static PCB** previous = NULL;  // Processo de cada CPU antes do passo multiprocessador
+static long* quantum_events = NULL;  // Último fim de quantum agendado de cada processo
+static ArrivalStream arrivals;  // Só a próxima chegada fica na fila de eventos
+
+static void arm_slice(PCB* process, long now) {
+    int index = process->pid - 1;
+    push_event(events, now + scheduler->slice_ms, EVENT_SLICE_END, process, epochs[index]);
+    armed[index] = true;
+}
+
+// Invalida os eventos pendentes do processo (preempção ou término)
+static void stop_process(PCB* process) {
+    int index = process->pid - 1;
+    epochs[index]++;
+    armed[index] = false;
+}
+
+static void preempt_monoprocessor(PCB* process) {
+    process->state = READY;
+    release_cpu(0);
+    stop_process(process);
+    enqueue_ready_process(process, 0);
+}
+
+static void handle_slice_end(Event* event) {
+    PCB* process = event->pcb;
+    if (event->epoch != epochs[process->pid - 1] || process->state != RUNNING) return;
+
+    armed[process->pid - 1] = false;
+
+    // Cada thread do processo em execução consome uma fatia
+    process->remaining_time -= scheduler->slice_ms * process_running_threads(process);
+    if (process->remaining_time <= 0) {
+        process->remaining_time = 0;
+        process->state = FINISHED;
+        push_event(events, event->time, EVENT_COMPLETION, process, event->epoch);
+        return;
+    }
+
+    arm_slice(process, event->time);
+}
+
+static void push_next_arrival() {
+    PCB* process = next_arrival(&arrivals);
+    if (process != NULL) {
+        push_event(events, process->start_time, EVENT_ARRIVAL, process, 0);
+    }
+}
+
+static void handle_arrival(Event* event) {
+    push_next_arrival();
+    enqueue_ready_process(event->pcb, ANY_CPU);
+
+    // PRIORITY/SRTF: a chegada de um processo melhor preempta na hora
+    if (scheduler->num_cpus == 1) {
+        PCB* running = scheduler->cpus[0].current_process;
+        if (running != NULL && running->state == RUNNING && should_preempt(event->pcb, running)) {
+            preempt_monoprocessor(running);
+            mark_preemption(0, event->pcb);
+        }
+    }
+}
+
+static void handle_completion(Event* event) {
+    PCB* process = event->pcb;
+    stop_process(process);
+
+    // Em multiprocessador a finalização é registrada por handle_multiprocessor_execution
+    if (scheduler->num_cpus == 1) {
+        log_process_finished(process);
+        release_cpu(0);
+    }
+}
+
+static void handle_quantum_expiry(Event* event) {
+    PCB* process = event->pcb;
+    if (event->epoch != epochs[process->pid - 1] || process->state != RUNNING) return;
+
+    // Em multiprocessador o evento apenas provoca o passo que trata o fim do quantum
+    if (scheduler->num_cpus > 1) return;
+
+    demote_process(process);
+    preempt_monoprocessor(process);
+}
+
+static void dispatch_monoprocessor(long now) {
+    if (scheduler->cpus[0].current_process != NULL) return;
+
+    PCB* process = select_next_process(0);
+    if (process == NULL) return;
+
+    process->state = RUNNING;
+    assign_process_to_cpu(0, process);
+    log_monoprocessor_dispatch(process);
+
+    arm_slice(process, now);
+    if (process->quantum_end_ms >= 0) {
+        push_event(events, process->quantum_end_ms, EVENT_QUANTUM_EXPIRY, process, epochs[process->pid - 1]);
+    }
+}
+
+static void step_multiprocessor(long now) {
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        previous[cpu] = scheduler->cpus[cpu].current_process;
+    }
+
+    schedule_multiprocessor();
+
+    // Processos preemptados no passo perdem a fatia em andamento
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        PCB* process = previous[cpu];
+        if (process != NULL && process->state == READY && armed[process->pid - 1]) {
+            stop_process(process);
+        }
+    }
+
+    // Agendar fatias dos processos que começaram a executar e os fins de quantum novos
+    for (int cpu = 0; cpu < scheduler->num_cpus; cpu++) {
+        PCB* process = scheduler->cpus[cpu].current_process;
+        if (process == NULL || process->state != RUNNING) continue;
+
+        int index = process->pid - 1;
+        if (!armed[index]) {
+            arm_slice(process, now);
+        }
+        if (multiprocessor_quantum_enabled() && process->quantum_end_ms != quantum_events[index]) {
+            push_event(events, process->quantum_end_ms, EVENT_QUANTUM_EXPIRY, process, epochs[index]);
+            quantum_events[index] = process->quantum_end_ms;
+        }
+    }
+}
+
+void run_virtual_simulation() {
+    events = create_event_queue();
+    epochs = calloc(num_processes, sizeof(int));
+    armed = calloc(num_processes, sizeof(bool));
+    previous = calloc(scheduler->num_cpus, sizeof(PCB*));
+    quantum_events = calloc(num_processes, sizeof(long));
+
+    if (!open_arrival_stream(&arrivals)) {
+        printf("Memória insuficiente para ordenar as chegadas\n");
+        exit(1);
+    }
+    push_next_arrival();
+
+    while (!is_event_queue_empty(events)) {
+        long now = peek_event_time(events);
+        advance_virtual_clock(now);
+
+        // Processar todos os eventos do instante atual antes de escalonar
+        Event event;
+        while (!is_event_queue_empty(events) && peek_event_time(events) == now) {
+            pop_event(events, &event);
+            switch (event.type) {
+                case EVENT_ARRIVAL:
+                    handle_arrival(&event);
+                    break;
+                case EVENT_SLICE_END:
+                    handle_slice_end(&event);
+                    break;
+                case EVENT_COMPLETION:
+                    handle_completion(&event);
+                    break;
+                case EVENT_QUANTUM_EXPIRY:
+                    handle_quantum_expiry(&event);
+                    break;
+            }
+        }
+
+        if (scheduler->num_cpus == 1) {
+            dispatch_monoprocessor(now);
+        } else {
+            step_multiprocessor(now);
+        }
+    }
+
+    scheduler->generator_done = true;
+    log_event(LOG_SCHEDULER_DONE, scheduler->scheduler_type, 0, LOG_NO_CPU, 0, 0);
+
+    destroy_event_queue(events);
+    close_arrival_stream(&arrivals);
+    free(epochs);
+    free(armed);
+    free(previous);
+    free(quantum_events);
+    events = NULL;
+    epochs = NULL;
+    armed = NULL;
+    previous = NULL;
+    quantum_events = NULL;
+}
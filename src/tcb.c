@@ -1,17 +1,38 @@
 #include "tcb.h"
+#include "arena.h"
 #include <stdlib.h>
+#include <pthread.h>
+
+#define TCBS_PER_BLOCK 1024
+
+// TCBs vêm de um slab compartilhado, liberado em bloco ao final
+static Slab* tcb_slab = NULL;
+static pthread_once_t tcb_slab_once = PTHREAD_ONCE_INIT;
+
+static void create_tcb_slab() {
+    tcb_slab = create_slab(sizeof(TCB), TCBS_PER_BLOCK);
+}
 
 TCB* create_tcb(PCB* pcb, int thread_index) {
-    TCB* tcb = malloc(sizeof(TCB));
+    pthread_once(&tcb_slab_once, create_tcb_slab);
+    
+    TCB* tcb = slab_alloc(tcb_slab);
     if (!tcb) return NULL;
     
     tcb->pcb = pcb;
     tcb->thread_index = thread_index;
+    tcb->armed = false;
+    tcb->slice_deadline_us = 0;
     
     return tcb;
 }
 
 void destroy_tcb(TCB* tcb) {
     if (!tcb) return;
-    free(tcb);
+    slab_free(tcb_slab, tcb);
+}
+
+void destroy_tcb_allocator() {
+    destroy_slab(tcb_slab);
+    tcb_slab = NULL;
 }
@@ -0,0 +1,199 @@
+#include "timer_wheel.h"
+#include <stddef.h>
+
+#define SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+#define WHEEL_SPAN (1L << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))  // Alcance em ticks
+
+static void list_append(TimerList* list, Timer* timer) {
+    timer->prev = list->tail;
+    timer->next = NULL;
+    if (list->tail) {
+        list->tail->next = timer;
+    } else {
+        list->head = timer;
+    }
+    list->tail = timer;
+}
+
+static void list_remove(TimerList* list, Timer* timer) {
+    if (timer->prev) {
+        timer->prev->next = timer->next;
+    } else {
+        list->head = timer->next;
+    }
+    if (timer->next) {
+        timer->next->prev = timer->prev;
+    } else {
+        list->tail = timer->prev;
+    }
+    timer->prev = NULL;
+    timer->next = NULL;
+}
+
+// Gira o bitmap para que o bit 0 corresponda à posição index
+static uint64_t rotate_bits(uint64_t bits, int index) {
+    return index == 0 ? bits : (bits >> index) | (bits << (TIMER_WHEEL_SLOTS - index));
+}
+
+// Nível pela distância até o vencimento; a posição vem dos bits absolutos do tick.
+// Um temporizador do nível L fica entre 1 e 64 blocos de 64^L ticks à frente
+static void place_timer(TimerWheel* wheel, Timer* timer) {
+    long tick = (timer->expires_us + TIMER_TICK_US - 1) / TIMER_TICK_US;
+    if (tick < wheel->current_tick) tick = wheel->current_tick;
+    
+    long delta = tick - wheel->current_tick;
+    if (delta >= WHEEL_SPAN) {
+        // Além do alcance: fica no último nível e é reposicionado nas cascatas
+        tick = wheel->current_tick + WHEEL_SPAN - 1;
+        delta = WHEEL_SPAN - 1;
+    }
+    
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1L << (TIMER_WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    int slot = (int)((tick >> (TIMER_WHEEL_BITS * level)) & SLOT_MASK);
+    
+    list_append(&wheel->slots[level][slot], timer);
+    wheel->occupied[level] |= 1ULL << slot;
+    timer->level = level;
+    timer->slot = slot;
+    wheel->count++;
+}
+
+// Redistribui uma posição do nível acima quando o tick atual entra no seu bloco
+static void cascade(TimerWheel* wheel, int level, int slot) {
+    Timer* timer = wheel->slots[level][slot].head;
+    wheel->slots[level][slot].head = NULL;
+    wheel->slots[level][slot].tail = NULL;
+    wheel->occupied[level] &= ~(1ULL << slot);
+    
+    while (timer) {
+        Timer* next = timer->next;
+        wheel->count--;
+        place_timer(wheel, timer);
+        timer = next;
+    }
+}
+
+// Próximo tick com algo a fazer: um vencimento no nível 0 ou o início do bloco
+// de uma posição ocupada de um nível acima (que ainda não foi redistribuída)
+static long next_tick(const TimerWheel* wheel) {
+    long best = -1;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        if (!wheel->occupied[level]) continue;
+        
+        int shift = TIMER_WHEEL_BITS * level;
+        long block = wheel->current_tick >> shift;
+        int index = (int)(block & SLOT_MASK);
+        
+        long tick;
+        if (level == 0) {
+            tick = wheel->current_tick + __builtin_ctzll(rotate_bits(wheel->occupied[0], index));
+        } else if ((wheel->current_tick & ((1L << shift) - 1)) == 0) {
+            // No início de um bloco a posição atual ainda não desceu
+            tick = (block + __builtin_ctzll(rotate_bits(wheel->occupied[level], index))) << shift;
+        } else {
+            int next_index = (index + 1) & SLOT_MASK;
+            tick = (block + 1 + __builtin_ctzll(rotate_bits(wheel->occupied[level], next_index))) << shift;
+        }
+        if (best < 0 || tick < best) best = tick;
+    }
+    return best;
+}
+
+void init_timer(Timer* timer, TimerCallback callback, void* data) {
+    timer->prev = NULL;
+    timer->next = NULL;
+    timer->expires_us = 0;
+    timer->level = TIMER_IDLE;
+    timer->slot = 0;
+    timer->callback = callback;
+    timer->data = data;
+}
+
+bool timer_pending(const Timer* timer) {
+    return timer->level != TIMER_IDLE;
+}
+
+void init_timer_wheel(TimerWheel* wheel, long now_us) {
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            wheel->slots[level][slot].head = NULL;
+            wheel->slots[level][slot].tail = NULL;
+        }
+        wheel->occupied[level] = 0;
+    }
+    wheel->expired.head = NULL;
+    wheel->expired.tail = NULL;
+    wheel->current_tick = now_us / TIMER_TICK_US;
+    wheel->count = 0;
+}
+
+void timer_wheel_add(TimerWheel* wheel, Timer* timer, long expires_us) {
+    timer_wheel_cancel(wheel, timer);
+    timer->expires_us = expires_us;
+    place_timer(wheel, timer);
+}
+
+void timer_wheel_cancel(TimerWheel* wheel, Timer* timer) {
+    if (timer->level == TIMER_EXPIRED) {
+        list_remove(&wheel->expired, timer);
+    } else if (timer->level >= 0) {
+        TimerList* list = &wheel->slots[timer->level][timer->slot];
+        list_remove(list, timer);
+        if (list->head == NULL) {
+            wheel->occupied[timer->level] &= ~(1ULL << timer->slot);
+        }
+        wheel->count--;
+    }
+    timer->level = TIMER_IDLE;
+}
+
+void timer_wheel_advance(TimerWheel* wheel, long now_us) {
+    long now_tick = now_us / TIMER_TICK_US;
+    
+    while (wheel->count > 0) {
+        long tick = next_tick(wheel);
+        if (tick > now_tick) break;
+        
+        // Ticks sem nada a fazer são pulados de uma vez
+        wheel->current_tick = tick;
+        for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+            int shift = TIMER_WHEEL_BITS * level;
+            if (tick & ((1L << shift) - 1)) break;
+            cascade(wheel, level, (int)((tick >> shift) & SLOT_MASK));
+        }
+        
+        int slot = (int)(tick & SLOT_MASK);
+        TimerList* list = &wheel->slots[0][slot];
+        while (list->head) {
+            Timer* timer = list->head;
+            list_remove(list, timer);
+            list_append(&wheel->expired, timer);
+            timer->level = TIMER_EXPIRED;
+            wheel->count--;
+        }
+        wheel->occupied[0] &= ~(1ULL << slot);
+        wheel->current_tick = tick + 1;
+    }
+    
+    if (wheel->current_tick <= now_tick) {
+        wheel->current_tick = now_tick + 1;
+    }
+}
+
+Timer* timer_wheel_pop_expired(TimerWheel* wheel) {
+    Timer* timer = wheel->expired.head;
+    if (timer) {
+        list_remove(&wheel->expired, timer);
+        timer->level = TIMER_IDLE;
+    }
+    return timer;
+}
+
+long timer_wheel_next_us(const TimerWheel* wheel) {
+    if (wheel->expired.head) return 0;
+    if (wheel->count == 0) return -1;
+    return next_tick(wheel) * TIMER_TICK_US;
+}
@@ -0,0 +1,240 @@
+#include "trace.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Cursor do analisador sobre o texto mapeado
+typedef struct {
+    const char* pos;
+    const char* end;
+    int line;
+} Scanner;
+
+static bool fail(char* error, size_t error_size, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(error, error_size, format, args);
+    va_end(args);
+    return false;
+}
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Avança até o próximo token, contando as linhas; falso no fim do arquivo
+static bool next_token(Scanner* scanner) {
+    while (scanner->pos < scanner->end && is_space(*scanner->pos)) {
+        if (*scanner->pos == '\n') scanner->line++;
+        scanner->pos++;
+    }
+    return scanner->pos < scanner->end;
+}
+
+// Inteiro de 32 bits delimitado por espaços ou pelo fim do arquivo
+static bool scan_int(Scanner* scanner, const char* what, int* value, char* error, size_t error_size) {
+    if (!next_token(scanner)) {
+        return fail(error, error_size, "linha %d: fim do arquivo, esperado %s", scanner->line, what);
+    }
+    
+    const char* p = scanner->pos;
+    bool negative = *p == '-';
+    if (*p == '-' || *p == '+') p++;
+    
+    long long number = 0;
+    const char* digits = p;
+    while (p < scanner->end && *p >= '0' && *p <= '9') {
+        number = number * 10 + (*p - '0');
+        if (number > (long long)INT_MAX + 1) break;
+        p++;
+    }
+    if (negative) number = -number;
+    
+    if (p == digits || (p < scanner->end && !is_space(*p)) || number > INT_MAX || number < INT_MIN) {
+        const char* token_end = scanner->pos;
+        while (token_end < scanner->end && !is_space(*token_end)) token_end++;
+        return fail(error, error_size, "linha %d: esperado %s, encontrado '%.*s'", scanner->line, what,
+                    (int)(token_end - scanner->pos < 32 ? token_end - scanner->pos : 32), scanner->pos);
+    }
+    
+    *value = (int)number;
+    scanner->pos = p;
+    return true;
+}
+
+// Palavra até o próximo espaço (truncada em size - 1); falso no fim do arquivo
+static bool scan_word(Scanner* scanner, char* word, size_t size) {
+    if (!next_token(scanner)) return false;
+    
+    size_t len = 0;
+    while (scanner->pos < scanner->end && !is_space(*scanner->pos)) {
+        if (len + 1 < size) word[len++] = *scanner->pos;
+        scanner->pos++;
+    }
+    word[len] = '\0';
+    return true;
+}
+
+// Valores aceitos para um processo (os mesmos nos dois formatos)
+static const char* invalid_field(const TraceRecord* record) {
+    if (record->process_len < 1) return "duração deve ser positiva";
+    if (record->priority < 0) return "prioridade negativa";
+    if (record->num_threads < 1) return "número de threads deve ser positivo";
+    if (record->start_time < 0) return "tempo de chegada negativo";
+    if (record->relative_deadline == 0 || record->relative_deadline < -1) return "prazo deve ser positivo";
+    if (record->tickets < 0) return "bilhetes negativos";
+    return NULL;
+}
+
+static bool parse_text(const char* data, size_t size, Trace* trace, char* error, size_t error_size) {
+    Scanner scanner = {data, data + size, 1};
+    
+    int count;
+    if (!scan_int(&scanner, "número de processos", &count, error, error_size)) return false;
+    if (count < 0) return fail(error, error_size, "linha %d: número de processos negativo", scanner.line);
+    
+    trace->parsed = malloc(((size_t)count + 1) * sizeof(TraceRecord));
+    if (!trace->parsed) return fail(error, error_size, "memória insuficiente para %d processos", count);
+    
+    for (int i = 0; i < count; i++) {
+        TraceRecord* record = &trace->parsed[i];
+        if (!scan_int(&scanner, "duração", &record->process_len, error, error_size) ||
+            !scan_int(&scanner, "prioridade", &record->priority, error, error_size) ||
+            !scan_int(&scanner, "número de threads", &record->num_threads, error, error_size) ||
+            !scan_int(&scanner, "tempo de chegada", &record->start_time, error, error_size)) {
+            return false;
+        }
+        record->relative_deadline = -1;
+        record->tickets = 0;
+        
+        const char* reason = invalid_field(record);
+        if (reason) return fail(error, error_size, "linha %d: processo %d: %s", scanner.line, i + 1, reason);
+    }
+    
+    if (!scan_int(&scanner, "código da política", &trace->policy, error, error_size)) return false;
+    
+    // Diretivas opcionais após a política, uma por processo: "deadline PID MS"
+    // (prazo relativo à chegada) e "tickets PID N" (bilhetes do stride/loteria)
+    char directive[32];
+    while (scan_word(&scanner, directive, sizeof(directive))) {
+        int line = scanner.line;
+        int pid, value;
+        if (!scan_int(&scanner, "PID", &pid, error, error_size) ||
+            !scan_int(&scanner, "valor da diretiva", &value, error, error_size)) {
+            return false;
+        }
+        if (pid < 1 || pid > count) return fail(error, error_size, "linha %d: PID inválido %d", line, pid);
+        
+        TraceRecord* record = &trace->parsed[pid - 1];
+        if (strcmp(directive, "deadline") == 0 && value > 0) {
+            record->relative_deadline = value;
+        } else if (strcmp(directive, "tickets") == 0 && value > 0) {
+            record->tickets = value;
+        } else {
+            return fail(error, error_size, "linha %d: diretiva inválida: %s %d %d", line, directive, pid, value);
+        }
+    }
+    
+    trace->num_processes = count;
+    trace->records = trace->parsed;
+    return true;
+}
+
+static bool parse_binary(const char* data, size_t size, Trace* trace, char* error, size_t error_size) {
+    const TraceHeader* header = (const TraceHeader*)data;
+    if (size < sizeof(TraceHeader) || header->num_processes < 0 ||
+        size - sizeof(TraceHeader) != (size_t)header->num_processes * sizeof(TraceRecord)) {
+        return fail(error, error_size, "carga binária truncada ou com tamanho inconsistente");
+    }
+    
+    trace->num_processes = header->num_processes;
+    trace->policy = header->policy;
+    trace->records = (const TraceRecord*)(data + sizeof(TraceHeader));
+    
+    for (int i = 0; i < trace->num_processes; i++) {
+        const char* reason = invalid_field(&trace->records[i]);
+        if (reason) return fail(error, error_size, "registro %d: %s", i + 1, reason);
+    }
+    return true;
+}
+
+bool load_trace(const char* filename, Trace* trace, char* error, size_t error_size) {
+    memset(trace, 0, sizeof(Trace));
+    
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return fail(error, error_size, "não foi possível abrir o arquivo");
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return fail(error, error_size, "arquivo vazio");
+    }
+    
+    // O mapeamento continua válido depois de fechar o descritor
+    trace->bytes = (size_t)info.st_size;
+    trace->mapping = mmap(NULL, trace->bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (trace->mapping == MAP_FAILED) {
+        trace->mapping = NULL;
+        return fail(error, error_size, "não foi possível mapear o arquivo");
+    }
+    madvise(trace->mapping, trace->bytes, MADV_SEQUENTIAL);
+    
+    const char* data = trace->mapping;
+    trace->binary = trace->bytes >= sizeof(TRACE_BINARY_MAGIC) &&
+                    memcmp(data, TRACE_BINARY_MAGIC, sizeof(TRACE_BINARY_MAGIC)) == 0;
+    
+    bool loaded = trace->binary ? parse_binary(data, trace->bytes, trace, error, error_size)
+                                : parse_text(data, trace->bytes, trace, error, error_size);
+    if (!loaded) free_trace(trace);
+    return loaded;
+}
+
+void free_trace(Trace* trace) {
+    if (trace->mapping) munmap(trace->mapping, trace->bytes);
+    free(trace->parsed);
+    trace->mapping = NULL;
+    trace->parsed = NULL;
+    trace->records = NULL;
+}
+
+bool write_binary_trace(const char* filename, const Trace* trace) {
+    FILE* file = fopen(filename, "wb");
+    if (!file) return false;
+    
+    TraceHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_BINARY_MAGIC, sizeof(TRACE_BINARY_MAGIC));
+    header.num_processes = trace->num_processes;
+    header.policy = trace->policy;
+    
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(trace->records, sizeof(TraceRecord), trace->num_processes, file) == (size_t)trace->num_processes;
+    return fclose(file) == 0 && ok;
+}
+
+bool write_text_trace(FILE* out, const Trace* trace) {
+    fprintf(out, "%d\n", trace->num_processes);
+    for (int i = 0; i < trace->num_processes; i++) {
+        const TraceRecord* record = &trace->records[i];
+        fprintf(out, "%d %d %d %d\n", record->process_len, record->priority, record->num_threads, record->start_time);
+    }
+    fprintf(out, "%d\n", trace->policy);
+    
+    for (int i = 0; i < trace->num_processes; i++) {
+        if (trace->records[i].relative_deadline > 0) {
+            fprintf(out, "deadline %d %d\n", i + 1, trace->records[i].relative_deadline);
+        }
+    }
+    for (int i = 0; i < trace->num_processes; i++) {
+        if (trace->records[i].tickets > 0) {
+            fprintf(out, "tickets %d %d\n", i + 1, trace->records[i].tickets);
+        }
+    }
+    return !ferror(out);
+}
@@ -0,0 +1,247 @@
+#define _GNU_SOURCE  // sched_setaffinity e macros CPU_*
+#include "worker_pool.h"
+#include "timer_wheel.h"
+#include "logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+// Roda de temporizadores com os workers que a atendem
+typedef struct {
+    TimerWheel wheel;
+    pthread_mutex_t mutex;
+    pthread_cond_t cv;
+    bool stop;
+    int host_core;          // Núcleo do executor fixado (-1 = livre entre os núcleos)
+    long* jitter_us;        // Atrasos de entrega observados pelos workers desta roda
+    long jitter_count;
+    long jitter_capacity;
+} TimerQueue;
+
+// Pool compartilhado: chegadas, despertar do escalonador e, sem fixação, as fatias
+static TimerQueue pool_queue;
+
+// Modo fixado: um executor por CPU simulada, dono das fatias das threads dela
+static TimerQueue* cpu_queues = NULL;
+static int cpu_queue_count = 0;
+
+static pthread_t* workers = NULL;
+static int worker_count = 0;
+
+TimerJitter timer_jitter = {NULL, 0, 0};
+
+static bool init_queue(TimerQueue* queue, int host_core) {
+    // Prazos em CLOCK_MONOTONIC, imunes a ajustes do relógio do sistema
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&queue->cv, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&queue->mutex, NULL);
+    
+    init_timer_wheel(&queue->wheel, get_monotonic_time_us());
+    queue->stop = false;
+    queue->host_core = host_core;
+    queue->jitter_count = 0;
+    queue->jitter_capacity = 1024;
+    queue->jitter_us = malloc(queue->jitter_capacity * sizeof(long));
+    return queue->jitter_us != NULL;
+}
+
+static void destroy_queue(TimerQueue* queue) {
+    pthread_cond_destroy(&queue->cv);
+    pthread_mutex_destroy(&queue->mutex);
+    free(queue->jitter_us);
+    queue->jitter_us = NULL;
+}
+
+// Chamada com o mutex da roda; sem memória, as amostras seguintes são descartadas
+static void record_jitter(TimerQueue* queue, long delay_us) {
+    if (queue->jitter_count == queue->jitter_capacity) {
+        long* grown = realloc(queue->jitter_us, 2 * queue->jitter_capacity * sizeof(long));
+        if (!grown) return;
+        queue->jitter_us = grown;
+        queue->jitter_capacity *= 2;
+    }
+    queue->jitter_us[queue->jitter_count++] = delay_us;
+}
+
+static void* worker_thread_function(void* arg) {
+    TimerQueue* queue = arg;
+    
+    // O núcleo foi validado em start_cpu_executors: a chamada vale só para esta thread
+    if (queue->host_core >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(queue->host_core, &set);
+        sched_setaffinity(0, sizeof(set), &set);
+    }
+    
+    pthread_mutex_lock(&queue->mutex);
+    while (!queue->stop) {
+        long now = get_monotonic_time_us();
+        timer_wheel_advance(&queue->wheel, now);
+        
+        Timer* timer = timer_wheel_pop_expired(&queue->wheel);
+        if (timer) {
+            record_jitter(queue, now - timer->expires_us);
+            TimerCallback callback = timer->callback;
+            pthread_mutex_unlock(&queue->mutex);
+            callback(timer);
+            pthread_mutex_lock(&queue->mutex);
+            continue;
+        }
+        
+        // Dormir até o próximo vencimento ou cascata (ou até um temporizador mais próximo chegar)
+        long next = timer_wheel_next_us(&queue->wheel);
+        if (next < 0) {
+            pthread_cond_wait(&queue->cv, &queue->mutex);
+            continue;
+        }
+        
+        struct timespec ts;
+        ts.tv_sec = next / 1000000;
+        ts.tv_nsec = (next % 1000000) * 1000;
+        pthread_cond_timedwait(&queue->cv, &queue->mutex, &ts);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    
+    return NULL;
+}
+
+int host_worker_count() {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (int)cores : 1;
+}
+
+bool start_worker_pool(int num_workers) {
+    if (num_workers < 1) num_workers = 1;
+    
+    workers = malloc(num_workers * sizeof(pthread_t));
+    if (!workers || !init_queue(&pool_queue, -1)) {
+        free(workers);
+        workers = NULL;
+        return false;
+    }
+    
+    worker_count = num_workers;
+    for (int i = 0; i < num_workers; i++) {
+        pthread_create(&workers[i], NULL, worker_thread_function, &pool_queue);
+    }
+    return true;
+}
+
+bool start_cpu_executors(int num_cpus, const int* host_cores, int num_cores) {
+    // Só núcleos em que o processo pode executar
+    cpu_set_t allowed;
+    if (num_cores < 1 || sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return false;
+    for (int i = 0; i < num_cores; i++) {
+        if (host_cores[i] < 0 || host_cores[i] >= CPU_SETSIZE || !CPU_ISSET(host_cores[i], &allowed)) {
+            return false;
+        }
+    }
+    
+    pthread_t* grown = realloc(workers, (worker_count + num_cpus) * sizeof(pthread_t));
+    cpu_queues = malloc(num_cpus * sizeof(TimerQueue));
+    if (grown) workers = grown;
+    if (!grown || !cpu_queues) {
+        free(cpu_queues);
+        cpu_queues = NULL;
+        return false;
+    }
+    
+    // CPUs além do conjunto de núcleos reaproveitam os núcleos em rodízio
+    for (int cpu = 0; cpu < num_cpus; cpu++) {
+        if (!init_queue(&cpu_queues[cpu], host_cores[cpu % num_cores])) return false;
+        cpu_queue_count++;
+        pthread_create(&workers[worker_count++], NULL, worker_thread_function, &cpu_queues[cpu]);
+    }
+    timer_jitter.pinned_cpus = num_cpus;
+    return true;
+}
+
+static void stop_queue(TimerQueue* queue) {
+    pthread_mutex_lock(&queue->mutex);
+    queue->stop = true;
+    pthread_cond_broadcast(&queue->cv);
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+// Junta as amostras de atraso de todas as rodas em timer_jitter
+static void collect_jitter(TimerQueue* queue) {
+    long* grown = realloc(timer_jitter.samples_us, (timer_jitter.count + queue->jitter_count + 1) * sizeof(long));
+    if (!grown) return;
+    
+    memcpy(grown + timer_jitter.count, queue->jitter_us, queue->jitter_count * sizeof(long));
+    timer_jitter.samples_us = grown;
+    timer_jitter.count += queue->jitter_count;
+}
+
+// Encerra os workers e executores; temporizadores ainda agendados são descartados
+void stop_worker_pool() {
+    if (!workers) return;
+    
+    stop_queue(&pool_queue);
+    for (int cpu = 0; cpu < cpu_queue_count; cpu++) {
+        stop_queue(&cpu_queues[cpu]);
+    }
+    for (int i = 0; i < worker_count; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    
+    collect_jitter(&pool_queue);
+    destroy_queue(&pool_queue);
+    for (int cpu = 0; cpu < cpu_queue_count; cpu++) {
+        collect_jitter(&cpu_queues[cpu]);
+        destroy_queue(&cpu_queues[cpu]);
+    }
+    
+    free(cpu_queues);
+    free(workers);
+    cpu_queues = NULL;
+    cpu_queue_count = 0;
+    workers = NULL;
+    worker_count = 0;
+}
+
+void free_timer_jitter() {
+    free(timer_jitter.samples_us);
+    timer_jitter.samples_us = NULL;
+    timer_jitter.count = 0;
+}
+
+static void add_queue_timer(TimerQueue* queue, Timer* timer, long expires_us) {
+    pthread_mutex_lock(&queue->mutex);
+    long next = timer_wheel_next_us(&queue->wheel);
+    timer_wheel_add(&queue->wheel, timer, expires_us);
+    
+    // Só é preciso acordar um worker se o novo temporizador vence antes da próxima verificação
+    if (next < 0 || expires_us < next) {
+        pthread_cond_signal(&queue->cv);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+// Agenda (ou reagenda) o temporizador para expires_us em CLOCK_MONOTONIC
+void add_timer(Timer* timer, long expires_us) {
+    add_queue_timer(&pool_queue, timer, expires_us);
+}
+
+// Sem executores (ou CPU fora deles), o temporizador vai para o pool compartilhado
+void add_cpu_timer(int cpu, Timer* timer, long expires_us) {
+    if (cpu >= 0 && cpu < cpu_queue_count) {
+        add_queue_timer(&cpu_queues[cpu], timer, expires_us);
+    } else {
+        add_timer(timer, expires_us);
+    }
+}
+
+// Um temporizador que já começou a executar não é interrompido
+void cancel_timer(Timer* timer) {
+    pthread_mutex_lock(&pool_queue.mutex);
+    timer_wheel_cancel(&pool_queue.wheel, timer);
+    pthread_mutex_unlock(&pool_queue.mutex);
+}
@@ -0,0 +1,39 @@
+// Conversor de cargas entre o formato texto de read_input e o binário compacto
+// (TraceHeader + TraceRecord, ver include/trace.h); o formato de entrada é detectado
+#include "trace.h"
+#include <stdio.h>
+#include <string.h>
+
+static void print_usage(const char* program) {
+    printf("Uso: %s ENTRADA SAIDA\n", program);
+    printf("  Texto -> binário, ou binário -> texto (SAIDA \"-\" escreve na saída padrão)\n");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    Trace trace;
+    char error[256];
+    if (!load_trace(argv[1], &trace, error, sizeof(error))) {
+        printf("Erro ao ler %s: %s\n", argv[1], error);
+        return 1;
+    }
+    
+    bool ok;
+    if (trace.binary) {
+        FILE* out = strcmp(argv[2], "-") == 0 ? stdout : fopen(argv[2], "w");
+        ok = out != NULL && write_text_trace(out, &trace);
+        if (out != NULL && out != stdout) ok = fclose(out) == 0 && ok;
+    } else {
+        ok = write_binary_trace(argv[2], &trace);
+    }
+    
+    if (!ok) {
+        printf("Erro ao gravar %s\n", argv[2]);
+    }
+    free_trace(&trace);
+    return ok ? 0 : 1;
+}
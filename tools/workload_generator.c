@@ -0,0 +1,235 @@
+// Gerador de cargas sintéticas no formato lido por read_input:
+// N, depois "duração prioridade threads chegada" por processo, o código da política
+// e, opcionalmente, diretivas "deadline PID MS" e "tickets PID N" por processo
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <getopt.h>
+
+// Distribuição de valores inteiros
+typedef enum {
+    DIST_FIXED,
+    DIST_UNIFORM,
+    DIST_EXPONENTIAL
+} DistributionType;
+
+typedef struct {
+    DistributionType type;
+    double a;   // Valor fixo, mínimo ou média
+    double b;   // Máximo (uniforme)
+} Distribution;
+
+// Processo de chegada
+typedef enum {
+    ARRIVAL_POISSON,
+    ARRIVAL_BURSTY,
+    ARRIVAL_FIXED
+} ArrivalType;
+
+// xorshift64*: sequência reprodutível em qualquer plataforma
+static uint64_t rng_state = 1;
+
+static uint64_t next_random() {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 2685821657736338717ULL;
+}
+
+// Uniforme em (0, 1]
+static double next_unit() {
+    return ((next_random() >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+static double next_exponential(double mean) {
+    return -mean * log(next_unit());
+}
+
+static long sample(const Distribution* dist) {
+    switch (dist->type) {
+        case DIST_UNIFORM:
+            return (long)dist->a + (long)(next_random() % (uint64_t)((long)dist->b - (long)dist->a + 1));
+        case DIST_EXPONENTIAL:
+            return lround(next_exponential(dist->a));
+        case DIST_FIXED:
+        default:
+            return lround(dist->a);
+    }
+}
+
+// Formatos: fixed:V | uniform:MIN:MAX | exp:MÉDIA
+static bool parse_distribution(const char* text, Distribution* dist) {
+    double a, b;
+    if (sscanf(text, "uniform:%lf:%lf", &a, &b) == 2 && a <= b) {
+        dist->type = DIST_UNIFORM;
+    } else if (sscanf(text, "exp:%lf", &a) == 1 && a > 0) {
+        dist->type = DIST_EXPONENTIAL;
+        b = 0;
+    } else if (sscanf(text, "fixed:%lf", &a) == 1) {
+        dist->type = DIST_FIXED;
+        b = 0;
+    } else {
+        return false;
+    }
+    dist->a = a;
+    dist->b = b;
+    return true;
+}
+
+static long clamp_min(long value, long min) {
+    return value < min ? min : value;
+}
+
+static void print_usage(const char* program) {
+    printf("Uso: %s [opções] > carga.txt\n", program);
+    printf("  -n, --processes N     número de processos (padrão: 100)\n");
+    printf("  -p, --policy P        1=FCFS 2=RR 3=PRIORITY 4=SJF 5=SRTF 6=MLFQ 7=CFS 8=EDF\n");
+    printf("                        9=STRIDE 10=LOTTERY (padrão: 1)\n");
+    printf("  -a, --arrival MODO    poisson | bursty | fixed (padrão: poisson)\n");
+    printf("  -r, --interval MS     intervalo médio entre chegadas (padrão: 100)\n");
+    printf("  -b, --burst N         processos por rajada no modo bursty (padrão: 10)\n");
+    printf("  -l, --length DIST     duração em ms (padrão: uniform:100:2000)\n");
+    printf("  -P, --priority DIST   prioridade (padrão: uniform:1:5)\n");
+    printf("  -t, --threads DIST    threads por processo (padrão: uniform:1:4)\n");
+    printf("  -D, --deadline DIST   prazo relativo à chegada em ms (padrão: sem prazo)\n");
+    printf("  -T, --tickets DIST    bilhetes do stride/loteria (padrão: derivados da prioridade)\n");
+    printf("  -s, --seed S          semente (padrão: 1)\n");
+    printf("DIST: fixed:V | uniform:MIN:MAX | exp:MÉDIA\n");
+}
+
+int main(int argc, char* argv[]) {
+    long num_processes = 100;
+    int policy = 1;
+    ArrivalType arrival = ARRIVAL_POISSON;
+    double interval_ms = 100;
+    long burst_size = 10;
+    Distribution length = {DIST_UNIFORM, 100, 2000};
+    Distribution priority = {DIST_UNIFORM, 1, 5};
+    Distribution threads = {DIST_UNIFORM, 1, 4};
+    Distribution deadline;
+    bool with_deadlines = false;
+    Distribution tickets;
+    bool with_tickets = false;
+    
+    static struct option long_options[] = {
+        {"processes", required_argument, NULL, 'n'},
+        {"policy", required_argument, NULL, 'p'},
+        {"arrival", required_argument, NULL, 'a'},
+        {"interval", required_argument, NULL, 'r'},
+        {"burst", required_argument, NULL, 'b'},
+        {"length", required_argument, NULL, 'l'},
+        {"priority", required_argument, NULL, 'P'},
+        {"threads", required_argument, NULL, 't'},
+        {"deadline", required_argument, NULL, 'D'},
+        {"tickets", required_argument, NULL, 'T'},
+        {"seed", required_argument, NULL, 's'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    
+    int opt;
+    bool valid = true;
+    while ((opt = getopt_long(argc, argv, "n:p:a:r:b:l:P:t:D:T:s:h", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'n':
+                num_processes = atol(optarg);
+                valid = valid && num_processes >= 0;
+                break;
+            case 'p':
+                policy = atoi(optarg);
+                valid = valid && policy >= 1;
+                break;
+            case 'a':
+                if (strcmp(optarg, "poisson") == 0) arrival = ARRIVAL_POISSON;
+                else if (strcmp(optarg, "bursty") == 0) arrival = ARRIVAL_BURSTY;
+                else if (strcmp(optarg, "fixed") == 0) arrival = ARRIVAL_FIXED;
+                else valid = false;
+                break;
+            case 'r':
+                interval_ms = atof(optarg);
+                valid = valid && interval_ms >= 0;
+                break;
+            case 'b':
+                burst_size = atol(optarg);
+                valid = valid && burst_size >= 1;
+                break;
+            case 'l':
+                valid = valid && parse_distribution(optarg, &length);
+                break;
+            case 'P':
+                valid = valid && parse_distribution(optarg, &priority);
+                break;
+            case 't':
+                valid = valid && parse_distribution(optarg, &threads);
+                break;
+            case 'D':
+                with_deadlines = true;
+                valid = valid && parse_distribution(optarg, &deadline);
+                break;
+            case 'T':
+                with_tickets = true;
+                valid = valid && parse_distribution(optarg, &tickets);
+                break;
+            case 's':
+                rng_state = strtoull(optarg, NULL, 10);
+                if (rng_state == 0) rng_state = 1;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                valid = false;
+                break;
+        }
+    }
+    
+    if (!valid || optind != argc) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    printf("%ld\n", num_processes);
+    
+    double clock_ms = 0;
+    for (long i = 0; i < num_processes; i++) {
+        // Chegadas: Poisson (intervalos exponenciais), rajadas com a mesma taxa
+        // média (burst_size processos juntos) ou intervalos fixos
+        if (i > 0) {
+            switch (arrival) {
+                case ARRIVAL_POISSON:
+                    clock_ms += next_exponential(interval_ms);
+                    break;
+                case ARRIVAL_BURSTY:
+                    if (i % burst_size == 0) clock_ms += next_exponential(interval_ms * burst_size);
+                    break;
+                case ARRIVAL_FIXED:
+                    clock_ms += interval_ms;
+                    break;
+            }
+        }
+        
+        printf("%ld %ld %ld %ld\n",
+               clamp_min(sample(&length), 1),
+               clamp_min(sample(&priority), 0),
+               clamp_min(sample(&threads), 1),
+               (long)clock_ms);
+    }
+    
+    printf("%d\n", policy);
+    
+    // Diretivas depois da política, sorteadas após as cargas para não alterar a sequência delas
+    if (with_deadlines) {
+        for (long i = 0; i < num_processes; i++) {
+            printf("deadline %ld %ld\n", i + 1, clamp_min(sample(&deadline), 1));
+        }
+    }
+    if (with_tickets) {
+        for (long i = 0; i < num_processes; i++) {
+            printf("tickets %ld %ld\n", i + 1, clamp_min(sample(&tickets), 1));
+        }
+    }
+    return 0;
+}